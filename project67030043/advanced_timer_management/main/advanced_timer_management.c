@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include "freertos/FreeRTOS.h"
@@ -11,16 +12,49 @@
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_random.h"
-#include "driver/gpio.h"
+
+#include "gpio_compat.h"
 
 static const char *TAG = "ADV_TIMERS";
 
 // ================ CONFIGURATION ================
-#define TIMER_POOL_SIZE              20
+#define TIMER_POOL_CHUNK_SIZE        16     // entries added per growth step
+#define TIMER_POOL_MAX_CHUNKS        64
+#define TIMER_POOL_CAPACITY          (TIMER_POOL_CHUNK_SIZE * TIMER_POOL_MAX_CHUNKS)
+#define TIMER_POOL_INDEX_BITS        16     // timer id = generation << 16 | index
+#define TIMER_POOL_INDEX_MASK        ((1UL << TIMER_POOL_INDEX_BITS) - 1)
 #define DYNAMIC_TIMER_MAX            10
-#define PERFORMANCE_BUFFER_SIZE      100
+
+// Latency histograms: log-linear buckets, 8 per power of two (< 12.5% error)
+#define LATENCY_SUB_BITS             3
+#define LATENCY_SUB_COUNT            (1 << LATENCY_SUB_BITS)
+#define LATENCY_MAX_BITS             20     // values clamp just above 1 s
+#define LATENCY_BUCKETS              ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS)
+#define LATENCY_TRACKED_TIMERS       8      // plus one shared overflow slot
+#define LATENCY_SLOT_RETIRED         UINT32_MAX   // released, awaiting its last export
+#define LATENCY_EXPORT_ROW_BYTES     (128 + LATENCY_BUCKETS * 20)   // every bucket non-empty
+#define DEADLINE_TOLERANCE_US        (portTICK_PERIOD_MS * 1000)   // start is tick-quantised
+
+// Periodic control loops that prove deadline tracking on both backends
+#define CONTROL_LOOP_PERIOD_MS       20
+#define WHEEL_LOOP_PERIOD_MS         50
 #define HEALTH_CHECK_INTERVAL        1000
 
+// Timing wheel: 4 levels of 64 slots, one slot per RTOS tick at level 0
+#define WHEEL_BITS                   6
+#define WHEEL_SLOTS                  (1 << WHEEL_BITS)
+#define WHEEL_MASK                   (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS                 4
+#define WHEEL_MAX_DELAY              ((1UL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+// Connection-timeout workload and wheel vs. daemon benchmark
+#define WHEEL_CONN_COUNT             5000
+#define WHEEL_CONN_MIN_TIMEOUT_MS    2000
+#define WHEEL_CONN_MAX_TIMEOUT_MS    30000
+#define WHEEL_CONN_KEEPALIVES        200    // restarts per 100 ms round
+#define WHEEL_BENCH_MIN_DELAY        1000   // ticks, so nothing fires mid-benchmark
+#define WHEEL_BENCH_MAX_DELAY        100000
+
 // LEDs for visual feedback
 #define PERFORMANCE_LED     GPIO_NUM_2
 #define HEALTH_LED         GPIO_NUM_4
@@ -29,30 +63,91 @@ static const char *TAG = "ADV_TIMERS";
 
 // ================ DATA STRUCTURES ================
 
+// Timing Wheel Timer: embedded in its owner, so starting one never allocates
+typedef struct wheel_timer wheel_timer_t;
+typedef void (*wheel_callback_t)(wheel_timer_t* timer, void* context);
+
+struct wheel_timer {
+    wheel_timer_t* next;
+    wheel_timer_t** pprev;       // Link that points at us, NULL when inactive
+    uint32_t expires;            // Tick count at which the timer fires
+    uint32_t period;             // Re-armed by this many ticks on expiry, 0 for one-shot
+    wheel_callback_t callback;
+    void* context;
+};
+
+// Hierarchical Timing Wheel
+typedef struct {
+    portMUX_TYPE lock;
+    uint32_t now;                // Next tick to be processed
+    wheel_timer_t* slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    wheel_timer_t* expiring;     // Timers detached from the current slot
+    wheel_timer_t* running;      // Timer whose callback is executing, NULL otherwise
+    TimerHandle_t driver;
+    uint32_t active;
+    uint32_t peak_active;
+    uint32_t fired;
+    uint32_t cascaded;
+    uint32_t max_lag_ticks;      // Worst catch-up after a late daemon wakeup
+} timing_wheel_t;
+
+// Latency Histogram: every field is updated with atomics, nothing is dropped
+typedef struct {
+    uint32_t counts[LATENCY_BUCKETS];
+    uint32_t total;
+    uint32_t max_us;
+    uint64_t sum_us;
+} latency_histogram_t;
+
 // Timer Pool Entry
 typedef struct {
-    TimerHandle_t handle;
+    TimerHandle_t handle;        // FreeRTOS timer, NULL for wheel-backed entries
     bool in_use;
-    uint32_t id;
+    bool armed;                  // Counted in timer_pool_active
+    bool on_wheel;
+    uint32_t id;                 // 0 while free
+    uint16_t generation;         // Bumped on release, so old ids stop matching
+    int32_t next_free;           // Free list link, -1 ends the list
     char name[16];
     TickType_t period;
     bool auto_reload;
     TimerCallbackFunction_t callback;
+    wheel_callback_t wheel_callback;
     void* context;
+    wheel_timer_t wheel;
     uint32_t creation_time;
     uint32_t start_count;
     uint32_t callback_count;
+    
+    // Deadline tracking in 64-bit esp_timer microseconds
+    int64_t next_deadline_us;        // When the next firing is due, 0 when not armed
+    int64_t drift_us;                // Actual - scheduled at the last firing
+    int64_t max_drift_us;
+    uint32_t deadline_misses;        // Fired more than DEADLINE_TOLERANCE_US late
+    latency_histogram_t* lateness;   // Allocated on first start, kept across reuse
 } timer_pool_entry_t;
 
-// Performance Metrics
+// Connection with an idle timeout, as in the connection-timeout workload
 typedef struct {
-    uint32_t callback_start_time;
-    uint32_t callback_duration_us;
-    uint32_t timer_id;
-    BaseType_t service_task_priority;
-    uint32_t queue_length;
-    bool accuracy_ok;
-} performance_sample_t;
+    wheel_timer_t timeout;
+    uint32_t keepalives;
+} wheel_connection_t;
+
+// Per-timer Performance Metrics, claimed by timer id on first sample
+typedef struct {
+    uint32_t timer_id;           // 0 while unclaimed, LATENCY_SLOT_RETIRED once released
+    uint32_t retired_id;         // Released owner, labels the slot's last export
+    int64_t last_fire_us;        // Only the daemon task writes this
+    uint32_t accurate;           // Intervals within ±5% of the period
+    latency_histogram_t duration;
+    latency_histogram_t jitter;  // |actual interval - period|
+} timer_latency_t;
+
+// Exporter's copy of the counts it last sent, for delta rows
+typedef struct {
+    uint32_t duration[LATENCY_BUCKETS];
+    uint32_t jitter[LATENCY_BUCKETS];
+} latency_export_t;
 
 // System Health Data
 typedef struct {
@@ -71,20 +166,28 @@ typedef struct {
 // ================ GLOBAL VARIABLES ================
 
 // Timer Pool Management
-timer_pool_entry_t timer_pool[TIMER_POOL_SIZE];
+// Chunks are only ever added, so entry pointers and lock-free lookups stay valid
+timer_pool_entry_t* timer_pool_chunks[TIMER_POOL_MAX_CHUNKS];
+uint32_t timer_pool_chunk_count = 0;
+int32_t timer_pool_free_head = -1;
+uint32_t timer_pool_in_use = 0;
+uint32_t timer_pool_active = 0;  // Armed entries, kept current without the mutex
 SemaphoreHandle_t pool_mutex;
-uint32_t next_timer_id = 1000;
+uint32_t next_timer_id = 1000;   // Dynamic (non-pool) timers; below any pool id
 
 // Performance Monitoring
-performance_sample_t perf_buffer[PERFORMANCE_BUFFER_SIZE];
-uint32_t perf_buffer_index = 0;
-SemaphoreHandle_t perf_mutex;
+timer_latency_t timer_latency[LATENCY_TRACKED_TIMERS + 1];
+latency_export_t latency_exported[LATENCY_TRACKED_TIMERS + 1];
 
 // Health Monitoring
 timer_health_t health_data = {0};
 TimerHandle_t health_monitor_timer;
 TimerHandle_t performance_timer;
 
+// Timing Wheel
+timing_wheel_t timing_wheel = {.lock = portMUX_INITIALIZER_UNLOCKED};
+uint32_t wheel_connection_timeouts = 0;
+
 // Dynamic Timer Tracking
 TimerHandle_t dynamic_timers[DYNAMIC_TIMER_MAX];
 uint32_t dynamic_timer_count = 0;
@@ -93,22 +196,358 @@ uint32_t dynamic_timer_count = 0;
 QueueHandle_t test_result_queue;
 TaskHandle_t stress_test_task_handle;
 
+// ================ TIMING WHEEL ================
+
+// Link a timer into the level whose span covers its remaining delay (lock held)
+static void wheel_link(wheel_timer_t* timer) {
+    int32_t delta = (int32_t)(timer->expires - timing_wheel.now);
+    wheel_timer_t** head;
+    
+    if (delta < 0) {
+        // Already due: the slot about to be processed
+        head = &timing_wheel.slots[0][timing_wheel.now & WHEEL_MASK];
+    } else {
+        if ((uint32_t)delta > WHEEL_MAX_DELAY) {
+            // Only after a very long daemon stall; fire at the far edge instead of wrapping
+            timer->expires = timing_wheel.now + WHEEL_MAX_DELAY;
+            delta = WHEEL_MAX_DELAY;
+        }
+        
+        int level = 0;
+        while (level < WHEEL_LEVELS - 1 &&
+               (uint32_t)delta >= (1UL << (WHEEL_BITS * (level + 1)))) {
+            level++;
+        }
+        head = &timing_wheel.slots[level][(timer->expires >> (WHEEL_BITS * level)) & WHEEL_MASK];
+    }
+    
+    timer->next = *head;
+    if (*head) {
+        (*head)->pprev = &timer->next;
+    }
+    *head = timer;
+    timer->pprev = head;
+}
+
+static void wheel_unlink(wheel_timer_t* timer) {
+    *timer->pprev = timer->next;
+    if (timer->next) {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+// Re-file one higher-level slot into the levels below; returns its index
+static uint32_t wheel_cascade(int level) {
+    uint32_t index = (timing_wheel.now >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    wheel_timer_t* timer = timing_wheel.slots[level][index];
+    
+    timing_wheel.slots[level][index] = NULL;
+    while (timer) {
+        wheel_timer_t* next = timer->next;
+        wheel_link(timer);
+        timing_wheel.cascaded++;
+        timer = next;
+    }
+    return index;
+}
+
+void wheel_timer_init(wheel_timer_t* timer, wheel_callback_t callback, void* context) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->period = 0;
+    timer->callback = callback;
+    timer->context = context;
+}
+
+static void wheel_arm(wheel_timer_t* timer, uint32_t expires) {
+    taskENTER_CRITICAL(&timing_wheel.lock);
+    if (timer->pprev) {
+        wheel_unlink(timer);
+    } else {
+        timing_wheel.active++;
+        if (timing_wheel.active > timing_wheel.peak_active) {
+            timing_wheel.peak_active = timing_wheel.active;
+        }
+    }
+    timer->expires = expires;
+    wheel_link(timer);
+    taskEXIT_CRITICAL(&timing_wheel.lock);
+}
+
+// Start or restart: O(1), no daemon command queue involved
+void wheel_timer_start(wheel_timer_t* timer, TickType_t delay) {
+    if (delay > WHEEL_MAX_DELAY) {
+        delay = WHEEL_MAX_DELAY;
+    }
+    wheel_arm(timer, xTaskGetTickCount() + delay);
+}
+
+// Periodic timers are re-armed by the tick, under the wheel lock, one period
+// after the previous expiry rather than after "now", so they keep their phase
+// like a FreeRTOS auto-reload timer and a stop can never be undone by a re-arm
+void wheel_timer_set_period(wheel_timer_t* timer, TickType_t period) {
+    if (period > WHEEL_MAX_DELAY) {
+        period = WHEEL_MAX_DELAY;
+    }
+    taskENTER_CRITICAL(&timing_wheel.lock);
+    timer->period = period;
+    taskEXIT_CRITICAL(&timing_wheel.lock);
+}
+
+// Stop: O(1). A callback already running on the daemon is not waited for.
+void wheel_timer_stop(wheel_timer_t* timer) {
+    taskENTER_CRITICAL(&timing_wheel.lock);
+    if (timer->pprev) {
+        wheel_unlink(timer);
+        timing_wheel.active--;
+    }
+    taskEXIT_CRITICAL(&timing_wheel.lock);
+}
+
+// Stop and wait for a callback already running on the daemon to return, so
+// the timer's memory can be reused. From a wheel callback (the daemon task)
+// nothing can be running but the caller itself, which is not waited for.
+void wheel_timer_stop_sync(wheel_timer_t* timer) {
+    wheel_timer_stop(timer);
+    if (xTaskGetCurrentTaskHandle() == xTimerGetTimerDaemonTaskHandle()) {
+        return;
+    }
+    while (__atomic_load_n(&timing_wheel.running, __ATOMIC_ACQUIRE) == timer) {
+        vTaskDelay(1);
+    }
+}
+
+bool wheel_timer_is_active(const wheel_timer_t* timer) {
+    return timer->pprev != NULL;
+}
+
+// Process every tick up to the current tick count, callbacks outside the lock
+void wheel_tick_callback(TimerHandle_t timer) {
+    TickType_t target = xTaskGetTickCount();
+    
+    taskENTER_CRITICAL(&timing_wheel.lock);
+    uint32_t lag = target - timing_wheel.now;
+    if ((int32_t)lag > 0 && lag > timing_wheel.max_lag_ticks) {
+        timing_wheel.max_lag_ticks = lag;
+    }
+    
+    while ((int32_t)(target - timing_wheel.now) >= 0) {
+        uint32_t index = timing_wheel.now & WHEEL_MASK;
+        
+        if (index == 0) {
+            for (int level = 1; level < WHEEL_LEVELS; level++) {
+                if (wheel_cascade(level) != 0) {
+                    break;
+                }
+            }
+        }
+        
+        // Detach the slot so timers restarted by their callback land elsewhere
+        timing_wheel.expiring = timing_wheel.slots[0][index];
+        timing_wheel.slots[0][index] = NULL;
+        if (timing_wheel.expiring) {
+            timing_wheel.expiring->pprev = &timing_wheel.expiring;
+        }
+        timing_wheel.now++;
+        
+        while (timing_wheel.expiring) {
+            wheel_timer_t* expired = timing_wheel.expiring;
+            wheel_unlink(expired);
+            timing_wheel.fired++;
+            if (expired->period) {
+                expired->expires += expired->period;
+                wheel_link(expired);
+            } else {
+                timing_wheel.active--;
+            }
+            __atomic_store_n(&timing_wheel.running, expired, __ATOMIC_RELEASE);
+            
+            taskEXIT_CRITICAL(&timing_wheel.lock);
+            expired->callback(expired, expired->context);
+            taskENTER_CRITICAL(&timing_wheel.lock);
+            
+            __atomic_store_n(&timing_wheel.running, NULL, __ATOMIC_RELEASE);
+        }
+    }
+    taskEXIT_CRITICAL(&timing_wheel.lock);
+}
+
+void init_timing_wheel(void) {
+    timing_wheel.now = xTaskGetTickCount();
+    
+    // One auto-reload daemon timer drives every wheel timer
+    timing_wheel.driver = xTimerCreate("WheelTick", 1, pdTRUE, (void*)3, wheel_tick_callback);
+    if (timing_wheel.driver && xTimerStart(timing_wheel.driver, 0) == pdPASS) {
+        ESP_LOGI(TAG, "Timing wheel started: %d levels × %d slots, %lu tick range",
+                 WHEEL_LEVELS, WHEEL_SLOTS, WHEEL_MAX_DELAY);
+    } else {
+        ESP_LOGE(TAG, "Failed to start timing wheel driver");
+    }
+}
+
+void print_wheel_stats(void) {
+    ESP_LOGI(TAG, "⏱️ Timing Wheel:");
+    ESP_LOGI(TAG, "  Active: %lu (peak %lu)", timing_wheel.active, timing_wheel.peak_active);
+    ESP_LOGI(TAG, "  Fired: %lu, Cascaded: %lu", timing_wheel.fired, timing_wheel.cascaded);
+    ESP_LOGI(TAG, "  Max Catch-up: %lu ticks", timing_wheel.max_lag_ticks);
+    ESP_LOGI(TAG, "  Connection Timeouts: %lu", wheel_connection_timeouts);
+}
+
 // ================ TIMER POOL MANAGEMENT ================
 
+// Add one chunk of free entries; caller holds pool_mutex
+static bool grow_timer_pool(void) {
+    if (timer_pool_chunk_count >= TIMER_POOL_MAX_CHUNKS) {
+        return false;
+    }
+    
+    timer_pool_entry_t* chunk = calloc(TIMER_POOL_CHUNK_SIZE, sizeof(timer_pool_entry_t));
+    if (chunk == NULL) {
+        return false;
+    }
+    
+    uint32_t base = timer_pool_chunk_count * TIMER_POOL_CHUNK_SIZE;
+    for (int i = TIMER_POOL_CHUNK_SIZE - 1; i >= 0; i--) {
+        chunk[i].generation = 1;
+        chunk[i].next_free = timer_pool_free_head;
+        timer_pool_free_head = base + i;
+    }
+    
+    // Publish the chunk only once its entries are initialised
+    __atomic_store_n(&timer_pool_chunks[timer_pool_chunk_count], chunk, __ATOMIC_RELEASE);
+    timer_pool_chunk_count++;
+    return true;
+}
+
+static inline timer_pool_entry_t* pool_entry_at(uint32_t index) {
+    timer_pool_entry_t* chunk = __atomic_load_n(&timer_pool_chunks[index / TIMER_POOL_CHUNK_SIZE],
+                                                __ATOMIC_ACQUIRE);
+    return chunk ? &chunk[index % TIMER_POOL_CHUNK_SIZE] : NULL;
+}
+
+// O(1), lock-free: the index is in the id, the generation rejects stale ids
+timer_pool_entry_t* pool_lookup(uint32_t timer_id) {
+    uint32_t index = timer_id & TIMER_POOL_INDEX_MASK;
+    if ((timer_id >> TIMER_POOL_INDEX_BITS) == 0 || index >= TIMER_POOL_CAPACITY) {
+        return NULL;   // Not a pool id
+    }
+    
+    timer_pool_entry_t* entry = pool_entry_at(index);
+    if (entry == NULL || __atomic_load_n(&entry->id, __ATOMIC_ACQUIRE) != timer_id) {
+        return NULL;
+    }
+    return entry;
+}
+
 void init_timer_pool(void) {
     pool_mutex = xSemaphoreCreateMutex();
     
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        timer_pool[i].handle = NULL;
-        timer_pool[i].in_use = false;
-        timer_pool[i].id = 0;
-        memset(timer_pool[i].name, 0, sizeof(timer_pool[i].name));
-        timer_pool[i].creation_time = 0;
-        timer_pool[i].start_count = 0;
-        timer_pool[i].callback_count = 0;
+    xSemaphoreTake(pool_mutex, portMAX_DELAY);
+    grow_timer_pool();
+    xSemaphoreGive(pool_mutex);
+    
+    ESP_LOGI(TAG, "Timer pool initialized with %d slots (grows by %d up to %d)",
+             TIMER_POOL_CHUNK_SIZE, TIMER_POOL_CHUNK_SIZE, TIMER_POOL_CAPACITY);
+}
+
+void track_pool_deadline(timer_pool_entry_t* entry);   // Performance monitoring below
+void release_latency_slot(uint32_t timer_id);
+
+// Claim and fill a free slot; caller holds pool_mutex. The slot's id goes to
+// *timer_id but is not published: the caller finishes the entry (callback,
+// handle) and then calls publish_pool_entry, so a lookup never sees half of it
+static timer_pool_entry_t* claim_pool_entry(const char* name, TickType_t period,
+                                            bool auto_reload, void* context,
+                                            uint32_t* timer_id) {
+    if (timer_pool_free_head < 0 && !grow_timer_pool()) {
+        ESP_LOGW(TAG, "Timer pool exhausted");
+        health_data.failed_creations++;
+        return NULL;
+    }
+    
+    uint32_t index = timer_pool_free_head;
+    timer_pool_entry_t* entry = pool_entry_at(index);
+    timer_pool_free_head = entry->next_free;
+    timer_pool_in_use++;
+    
+    entry->in_use = true;
+    entry->armed = false;
+    entry->on_wheel = false;
+    entry->handle = NULL;
+    memset(entry->name, 0, sizeof(entry->name));
+    strncpy(entry->name, name, sizeof(entry->name) - 1);
+    entry->period = period;
+    entry->auto_reload = auto_reload;
+    entry->callback = NULL;
+    entry->wheel_callback = NULL;
+    entry->context = context;
+    entry->creation_time = xTaskGetTickCount();
+    entry->start_count = 0;
+    entry->callback_count = 0;
+    entry->next_deadline_us = 0;
+    entry->drift_us = 0;
+    entry->max_drift_us = 0;
+    entry->deadline_misses = 0;
+    if (entry->lateness) {
+        memset(entry->lateness, 0, sizeof(latency_histogram_t));
+    }
+    *timer_id = ((uint32_t)entry->generation << TIMER_POOL_INDEX_BITS) | index;
+    return entry;
+}
+
+static inline void publish_pool_entry(timer_pool_entry_t* entry, uint32_t timer_id) {
+    __atomic_store_n(&entry->id, timer_id, __ATOMIC_RELEASE);
+}
+
+// Only an actual change moves timer_pool_active, so repeated starts or stops are safe
+static void pool_entry_set_armed(timer_pool_entry_t* entry, bool armed) {
+    if (__atomic_exchange_n(&entry->armed, armed, __ATOMIC_RELAXED) != armed) {
+        if (armed) {
+            __atomic_fetch_add(&timer_pool_active, 1, __ATOMIC_RELAXED);
+        } else {
+            __atomic_fetch_sub(&timer_pool_active, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Return a claimed slot to the free list, published or not; caller holds pool_mutex
+static void unclaim_pool_entry(timer_pool_entry_t* entry, uint32_t timer_id) {
+    uint32_t index = timer_id & TIMER_POOL_INDEX_MASK;
+    
+    release_latency_slot(timer_id);
+    __atomic_store_n(&entry->id, 0, __ATOMIC_RELEASE);
+    pool_entry_set_armed(entry, false);
+    entry->generation = (entry->generation == UINT16_MAX) ? 1 : entry->generation + 1;
+    entry->in_use = false;
+    entry->handle = NULL;
+    entry->next_free = timer_pool_free_head;
+    timer_pool_free_head = index;
+    timer_pool_in_use--;
+}
+
+// Every pool timer fires through here, so deadlines are tracked for any callback
+static void pool_timer_dispatch(TimerHandle_t timer) {
+    uint32_t timer_id = (uint32_t)pvTimerGetTimerID(timer);
+    timer_pool_entry_t* entry = pool_lookup(timer_id);
+    if (entry == NULL) {
+        return;   // Released while the expiry was already queued
+    }
+    TimerCallbackFunction_t callback = entry->callback;
+    
+    if (!entry->auto_reload) {
+        pool_entry_set_armed(entry, false);   // The callback may start it again
     }
+    track_pool_deadline(entry);
+    __atomic_fetch_add(&entry->callback_count, 1, __ATOMIC_RELAXED);
     
-    ESP_LOGI(TAG, "Timer pool initialized with %d slots", TIMER_POOL_SIZE);
+    // Released (and maybe re-claimed) since the lookup: not ours to run any more
+    if (__atomic_load_n(&entry->id, __ATOMIC_ACQUIRE) != timer_id) {
+        return;
+    }
+    callback(timer);
 }
 
 timer_pool_entry_t* allocate_from_pool(const char* name, TickType_t period, 
@@ -119,62 +558,132 @@ timer_pool_entry_t* allocate_from_pool(const char* name, TickType_t period,
         return NULL;
     }
     
-    timer_pool_entry_t* entry = NULL;
-    
-    // Find free slot
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        if (!timer_pool[i].in_use) {
-            entry = &timer_pool[i];
-            entry->in_use = true;
-            entry->id = next_timer_id++;
-            strncpy(entry->name, name, sizeof(entry->name) - 1);
-            entry->period = period;
-            entry->auto_reload = auto_reload;
-            entry->callback = callback;
-            entry->context = context;
-            entry->creation_time = xTaskGetTickCount();
-            entry->start_count = 0;
-            entry->callback_count = 0;
-            
-            // Create actual timer
-            entry->handle = xTimerCreate(name, period, auto_reload, 
-                                       (void*)entry->id, callback);
-            
-            if (entry->handle == NULL) {
-                entry->in_use = false;
-                entry = NULL;
-                health_data.failed_creations++;
-            } else {
-                health_data.total_timers_created++;
-            }
-            break;
+    uint32_t timer_id;
+    timer_pool_entry_t* entry = claim_pool_entry(name, period, auto_reload, context, &timer_id);
+    if (entry != NULL) {
+        entry->callback = callback;
+        
+        // Create actual timer
+        entry->handle = xTimerCreate(name, period, auto_reload, 
+                                   (void*)timer_id, pool_timer_dispatch);
+        
+        if (entry->handle == NULL) {
+            unclaim_pool_entry(entry, timer_id);
+            entry = NULL;
+            health_data.failed_creations++;
+        } else {
+            publish_pool_entry(entry, timer_id);
+            health_data.total_timers_created++;
         }
     }
     
-    if (entry == NULL) {
-        ESP_LOGW(TAG, "Timer pool exhausted");
-        health_data.failed_creations++;
+    xSemaphoreGive(pool_mutex);
+    return entry;
+}
+
+// Auto-reload wheel entries were already re-armed by the tick, before this runs
+static void pool_wheel_dispatch(wheel_timer_t* timer, void* context) {
+    timer_pool_entry_t* entry = (timer_pool_entry_t*)context;
+    
+    track_pool_deadline(entry);
+    if (!entry->auto_reload) {
+        pool_entry_set_armed(entry, false);
+    }
+    entry->callback_count++;
+    entry->wheel_callback(timer, entry->context);
+}
+
+timer_pool_entry_t* allocate_wheel_from_pool(const char* name, TickType_t period,
+                                            bool auto_reload, wheel_callback_t callback,
+                                            void* context) {
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        ESP_LOGW(TAG, "Failed to acquire pool mutex");
+        return NULL;
+    }
+    
+    uint32_t timer_id;
+    timer_pool_entry_t* entry = claim_pool_entry(name, period, auto_reload, context, &timer_id);
+    if (entry != NULL) {
+        entry->on_wheel = true;
+        entry->wheel_callback = callback;
+        wheel_timer_init(&entry->wheel, pool_wheel_dispatch, entry);
+        if (auto_reload) {
+            wheel_timer_set_period(&entry->wheel, period);
+        }
+        publish_pool_entry(entry, timer_id);
+        health_data.total_timers_created++;
     }
     
     xSemaphoreGive(pool_mutex);
     return entry;
 }
 
+BaseType_t pool_timer_start(timer_pool_entry_t* entry) {
+    entry->start_count++;
+    if (entry->lateness == NULL) {
+        entry->lateness = calloc(1, sizeof(latency_histogram_t));
+    }
+    entry->next_deadline_us = esp_timer_get_time() + pdTICKS_TO_MS(entry->period) * 1000LL;
+    
+    // Armed before the start, so an expiry that beats our return still disarms it
+    pool_entry_set_armed(entry, true);
+    if (entry->on_wheel) {
+        wheel_timer_start(&entry->wheel, entry->period);
+        return pdPASS;
+    }
+    
+    BaseType_t result = xTimerStart(entry->handle, 0);
+    if (result != pdPASS) {
+        pool_entry_set_armed(entry, false);
+        health_data.command_failures++;
+    }
+    return result;
+}
+
+BaseType_t pool_timer_stop(timer_pool_entry_t* entry) {
+    entry->next_deadline_us = 0;
+    pool_entry_set_armed(entry, false);
+    if (entry->on_wheel) {
+        wheel_timer_stop(&entry->wheel);
+        return pdPASS;
+    }
+    
+    BaseType_t result = xTimerStop(entry->handle, pdMS_TO_TICKS(100));
+    if (result != pdPASS) {
+        pool_entry_set_armed(entry, true);   // Still running
+        health_data.command_failures++;
+    }
+    return result;
+}
+
+bool pool_timer_is_active(timer_pool_entry_t* entry) {
+    if (entry->on_wheel) {
+        return wheel_timer_is_active(&entry->wheel);
+    }
+    return xTimerIsTimerActive(entry->handle);
+}
+
 void release_to_pool(uint32_t timer_id) {
+    if (pool_lookup(timer_id) == NULL) {
+        ESP_LOGW(TAG, "Release of stale or unknown timer %lu", timer_id);
+        return;
+    }
+    
     if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
         return;
     }
     
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        if (timer_pool[i].in_use && timer_pool[i].id == timer_id) {
-            if (timer_pool[i].handle) {
-                xTimerDelete(timer_pool[i].handle, 0);
-            }
-            timer_pool[i].in_use = false;
-            timer_pool[i].handle = NULL;
-            ESP_LOGI(TAG, "Released timer %lu from pool", timer_id);
-            break;
+    // Re-check under the mutex: a concurrent release may have won
+    timer_pool_entry_t* entry = pool_lookup(timer_id);
+    if (entry != NULL) {
+        if (entry->on_wheel) {
+            // The slot must not be reclaimed under a callback still using it
+            wheel_timer_stop_sync(&entry->wheel);
+        } else if (entry->handle) {
+            xTimerDelete(entry->handle, 0);
         }
+        unclaim_pool_entry(entry, timer_id);
+        ESP_LOGI(TAG, "Released timer %lu from pool", timer_id);
     }
     
     xSemaphoreGive(pool_mutex);
@@ -182,67 +691,222 @@ void release_to_pool(uint32_t timer_id) {
 
 // ================ PERFORMANCE MONITORING ================
 
-void record_performance_sample(uint32_t timer_id, uint32_t duration_us, bool accuracy_ok) {
-    if (xSemaphoreTake(perf_mutex, 0) == pdTRUE) { // Non-blocking
-        performance_sample_t* sample = &perf_buffer[perf_buffer_index];
-        
-        sample->timer_id = timer_id;
-        sample->callback_duration_us = duration_us;
-        sample->accuracy_ok = accuracy_ok;
-        sample->callback_start_time = esp_timer_get_time() / 1000; // Convert to ms
-        sample->service_task_priority = uxTaskPriorityGet(NULL);
-        sample->queue_length = 0; // Would need special access to get this
-        
-        perf_buffer_index = (perf_buffer_index + 1) % PERFORMANCE_BUFFER_SIZE;
-        
-        if (duration_us > 1000) { // > 1ms is concerning
-            health_data.callback_overruns++;
+static inline uint32_t latency_bucket(uint32_t value_us) {
+    if (value_us >= (1UL << LATENCY_MAX_BITS)) {
+        value_us = (1UL << LATENCY_MAX_BITS) - 1;
+    }
+    if (value_us < LATENCY_SUB_COUNT) {
+        return value_us;
+    }
+    
+    uint32_t msb = 31 - __builtin_clz(value_us);
+    uint32_t shift = msb - LATENCY_SUB_BITS;
+    return ((shift + 1) << LATENCY_SUB_BITS) + ((value_us >> shift) & (LATENCY_SUB_COUNT - 1));
+}
+
+// Largest value that lands in a bucket, so percentiles never under-report
+static inline uint32_t latency_bucket_upper(uint32_t bucket) {
+    uint32_t group = bucket >> LATENCY_SUB_BITS;
+    if (group == 0) {
+        return bucket;
+    }
+    uint32_t sub = LATENCY_SUB_COUNT + (bucket & (LATENCY_SUB_COUNT - 1));
+    return ((sub + 1) << (group - 1)) - 1;
+}
+
+static void latency_record(latency_histogram_t* hist, uint32_t value_us) {
+    __atomic_fetch_add(&hist->counts[latency_bucket(value_us)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum_us, value_us, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->total, 1, __ATOMIC_RELAXED);
+    
+    uint32_t seen = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    while (value_us > seen &&
+           !__atomic_compare_exchange_n(&hist->max_us, &seen, value_us, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+// Percentile over a bucket array: one pass, no sorting
+uint32_t latency_percentile(const uint32_t* counts, uint32_t total, uint32_t percent_x10) {
+    if (total == 0) {
+        return 0;
+    }
+    
+    uint32_t rank = (uint32_t)(((uint64_t)total * percent_x10 + 999) / 1000);
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            return latency_bucket_upper(b);
         }
-        
-        xSemaphoreGive(perf_mutex);
     }
+    return latency_bucket_upper(LATENCY_BUCKETS - 1);
 }
 
-void analyze_performance(void) {
-    if (xSemaphoreTake(perf_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+// Bucket bounds can overshoot the largest sample; the exact max caps them
+static uint32_t latency_hist_percentile(const latency_histogram_t* hist, uint32_t percent_x10) {
+    uint32_t value = latency_percentile(hist->counts, hist->total, percent_x10);
+    return (value < hist->max_us) ? value : hist->max_us;
+}
+
+// Find or claim the slot for a timer; extra timers share the overflow slot.
+// A pool id released while its callback ran must not claim a slot again.
+static timer_latency_t* latency_slot(uint32_t timer_id) {
+    bool stale = (timer_id >> TIMER_POOL_INDEX_BITS) != 0 && pool_lookup(timer_id) == NULL;
+    if (timer_id != 0 && !stale) {
+        for (int i = 0; i < LATENCY_TRACKED_TIMERS; i++) {
+            uint32_t owner = __atomic_load_n(&timer_latency[i].timer_id, __ATOMIC_ACQUIRE);
+            // A failed claim leaves the winner's id in owner
+            if (owner == 0 &&
+                __atomic_compare_exchange_n(&timer_latency[i].timer_id, &owner, timer_id, false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return &timer_latency[i];
+            }
+            if (owner == timer_id) {
+                return &timer_latency[i];
+            }
+        }
+    }
+    return &timer_latency[LATENCY_TRACKED_TIMERS];
+}
+
+// A released id never fires again, but samples it left may not be exported
+// yet: the slot is retired, not cleared, and the exporter frees it after
+// sending them under the old id. Until then new timers use the overflow slot.
+void release_latency_slot(uint32_t timer_id) {
+    for (int i = 0; i < LATENCY_TRACKED_TIMERS; i++) {
+        timer_latency_t* slot = &timer_latency[i];
+        if (__atomic_load_n(&slot->timer_id, __ATOMIC_ACQUIRE) == timer_id) {
+            slot->retired_id = timer_id;
+            __atomic_store_n(&slot->timer_id, LATENCY_SLOT_RETIRED, __ATOMIC_RELEASE);
+            return;
+        }
+    }
+}
+
+void record_performance_sample(uint32_t timer_id, int64_t fire_time_us,
+                               uint32_t duration_us, uint32_t period_us) {
+    timer_latency_t* slot = latency_slot(timer_id);
+    
+    latency_record(&slot->duration, duration_us);
+    
+    // Jitter needs this timer's own previous firing; the overflow slot has none
+    if (slot != &timer_latency[LATENCY_TRACKED_TIMERS]) {
+        if (slot->last_fire_us > 0 && period_us > 0) {
+            int64_t interval_us = fire_time_us - slot->last_fire_us;
+            int64_t error_us = interval_us - period_us;
+            uint32_t jitter_us = (uint32_t)(error_us < 0 ? -error_us : error_us);
+            
+            latency_record(&slot->jitter, jitter_us);
+            if (jitter_us * 20 <= period_us) {
+                __atomic_fetch_add(&slot->accurate, 1, __ATOMIC_RELAXED);
+            }
+        }
+        slot->last_fire_us = fire_time_us;
+    }
+    
+    if (duration_us > 1000) { // > 1ms is concerning
+        __atomic_fetch_add(&health_data.callback_overruns, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Called at the top of every pool timer firing, on the daemon task
+void track_pool_deadline(timer_pool_entry_t* entry) {
+    int64_t now_us = esp_timer_get_time();
+    int64_t deadline_us = entry->next_deadline_us;
+    if (deadline_us == 0) {
+        return;   // Not armed through pool_timer_start()
+    }
+    
+    // The schedule advances by whole periods from the start, so drift accumulates
+    int64_t drift_us = now_us - deadline_us;
+    entry->drift_us = drift_us;
+    if (drift_us > entry->max_drift_us) {
+        entry->max_drift_us = drift_us;
+    }
+    if (drift_us > DEADLINE_TOLERANCE_US) {
+        entry->deadline_misses++;
+    }
+    if (entry->lateness) {
+        latency_record(entry->lateness, drift_us > 0 ? (uint32_t)drift_us : 0);
+    }
+    
+    entry->next_deadline_us = entry->auto_reload
+                            ? deadline_us + pdTICKS_TO_MS(entry->period) * 1000LL
+                            : 0;
+}
+
+void print_deadline_report(void) {
+    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
         return;
     }
     
-    uint32_t total_duration = 0;
+    ESP_LOGI(TAG, "🎯 Deadlines (late p50/p99/max μs, drift now/max μs):");
+    uint32_t capacity = timer_pool_chunk_count * TIMER_POOL_CHUNK_SIZE;
+    for (uint32_t i = 0; i < capacity; i++) {
+        timer_pool_entry_t* entry = pool_entry_at(i);
+        if (!entry->in_use || !entry->lateness || entry->lateness->total == 0) {
+            continue;
+        }
+        
+        ESP_LOGI(TAG, "  %-10s %6lu fires, %lu missed, late %lu/%lu/%lu, drift %lld/%lld",
+                 entry->name, entry->lateness->total, entry->deadline_misses,
+                 latency_hist_percentile(entry->lateness, 500),
+                 latency_hist_percentile(entry->lateness, 990), entry->lateness->max_us,
+                 entry->drift_us, entry->max_drift_us);
+    }
+    
+    xSemaphoreGive(pool_mutex);
+}
+
+void analyze_performance(void) {
+    uint64_t total_duration = 0;
     uint32_t max_duration = 0;
-    uint32_t min_duration = UINT32_MAX;
     uint32_t accurate_timers = 0;
+    uint32_t interval_count = 0;
     uint32_t sample_count = 0;
     
-    for (int i = 0; i < PERFORMANCE_BUFFER_SIZE; i++) {
-        if (perf_buffer[i].callback_duration_us > 0) {
-            total_duration += perf_buffer[i].callback_duration_us;
-            
-            if (perf_buffer[i].callback_duration_us > max_duration) {
-                max_duration = perf_buffer[i].callback_duration_us;
-            }
-            
-            if (perf_buffer[i].callback_duration_us < min_duration) {
-                min_duration = perf_buffer[i].callback_duration_us;
-            }
-            
-            if (perf_buffer[i].accuracy_ok) {
-                accurate_timers++;
-            }
-            
-            sample_count++;
+    ESP_LOGI(TAG, "📊 Performance Analysis (p50/p99/max μs):");
+    for (int i = 0; i <= LATENCY_TRACKED_TIMERS; i++) {
+        timer_latency_t* slot = &timer_latency[i];
+        if (slot->duration.total == 0) {
+            continue;
+        }
+        
+        if (i < LATENCY_TRACKED_TIMERS) {
+            uint32_t owner = slot->timer_id;
+            ESP_LOGI(TAG, "  Timer %lu: %lu fires, duration %lu/%lu/%lu, jitter %lu/%lu/%lu",
+                     (owner == LATENCY_SLOT_RETIRED) ? slot->retired_id : owner,
+                     slot->duration.total,
+                     latency_hist_percentile(&slot->duration, 500),
+                     latency_hist_percentile(&slot->duration, 990), slot->duration.max_us,
+                     latency_hist_percentile(&slot->jitter, 500),
+                     latency_hist_percentile(&slot->jitter, 990), slot->jitter.max_us);
+        } else {
+            ESP_LOGI(TAG, "  Untracked timers: %lu fires, duration %lu/%lu/%lu",
+                     slot->duration.total,
+                     latency_hist_percentile(&slot->duration, 500),
+                     latency_hist_percentile(&slot->duration, 990), slot->duration.max_us);
+        }
+        
+        total_duration += slot->duration.sum_us;
+        sample_count += slot->duration.total;
+        interval_count += slot->jitter.total;
+        accurate_timers += slot->accurate;
+        if (slot->duration.max_us > max_duration) {
+            max_duration = slot->duration.max_us;
         }
     }
     
     if (sample_count > 0) {
         uint32_t avg_duration = total_duration / sample_count;
-        health_data.average_accuracy = (float)accurate_timers / sample_count * 100.0;
+        if (interval_count > 0) {
+            health_data.average_accuracy = (float)accurate_timers / interval_count * 100.0;
+        }
         
-        ESP_LOGI(TAG, "📊 Performance Analysis:");
-        ESP_LOGI(TAG, "  Callback Duration: Avg=%luμs, Max=%luμs, Min=%luμs", 
-                 avg_duration, max_duration, min_duration);
+        ESP_LOGI(TAG, "  Callback Duration: Avg=%luμs, Max=%luμs", avg_duration, max_duration);
         ESP_LOGI(TAG, "  Timer Accuracy: %.1f%% (%lu/%lu)", 
-                 health_data.average_accuracy, accurate_timers, sample_count);
+                 health_data.average_accuracy, accurate_timers, interval_count);
         ESP_LOGI(TAG, "  Callback Overruns: %lu", health_data.callback_overruns);
         
         // Visual feedback
@@ -252,14 +916,76 @@ void analyze_performance(void) {
             gpio_set_level(PERFORMANCE_LED, 0);
         }
     }
+}
+
+// One CSV row per timer and metric with what arrived since the last export.
+// Counts only ever drop here: a final export takes them to zero for the
+// slot's next owner, along with the baseline.
+static void export_latency_delta(uint32_t timer_id, const char* metric,
+                                 uint32_t* counts, uint32_t* exported, bool final) {
+    uint32_t delta[LATENCY_BUCKETS];
+    uint32_t total = 0;
+    
+    static char row[LATENCY_EXPORT_ROW_BYTES];   // Only the analysis task exports
+    
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+        // Exchange, so a straggling sample lands before the reset or after it
+        uint32_t now = final ? __atomic_exchange_n(&counts[b], 0, __ATOMIC_RELAXED)
+                             : __atomic_load_n(&counts[b], __ATOMIC_RELAXED);
+        delta[b] = now - exported[b];
+        exported[b] = final ? 0 : now;
+        total += delta[b];
+    }
+    if (total == 0) {
+        return;
+    }
     
-    xSemaphoreGive(perf_mutex);
+    // Built first and written with one call, so log lines from other tasks
+    // cannot land inside a row
+    int len = snprintf(row, sizeof(row), "TIMER_HIST,%llu,%lu,%s,%lu,%lu,%lu,%lu,%lu,",
+                       esp_timer_get_time() / 1000, timer_id, metric, total,
+                       latency_percentile(delta, total, 500), latency_percentile(delta, total, 900),
+                       latency_percentile(delta, total, 990), latency_percentile(delta, total, 999));
+    for (int b = 0; b < LATENCY_BUCKETS && len < (int)sizeof(row); b++) {
+        if (delta[b]) {
+            len += snprintf(row + len, sizeof(row) - len, "%lu:%lu ",
+                            latency_bucket_upper(b), delta[b]);
+        }
+    }
+    printf("%s\n", row);
+}
+
+void export_latency_histograms(void) {
+    for (int i = 0; i <= LATENCY_TRACKED_TIMERS; i++) {
+        timer_latency_t* slot = &timer_latency[i];
+        uint32_t timer_id = (i < LATENCY_TRACKED_TIMERS)
+                          ? __atomic_load_n(&slot->timer_id, __ATOMIC_ACQUIRE) : 0;
+        bool retired = (timer_id == LATENCY_SLOT_RETIRED);
+        if (retired) {
+            timer_id = slot->retired_id;
+        }
+        
+        export_latency_delta(timer_id, "duration", slot->duration.counts,
+                             latency_exported[i].duration, retired);
+        export_latency_delta(timer_id, "jitter", slot->jitter.counts,
+                             latency_exported[i].jitter, retired);
+        
+        if (retired) {
+            // Everything is exported; clear the summaries and hand the slot back
+            slot->last_fire_us = 0;
+            slot->accurate = 0;
+            slot->duration.total = slot->jitter.total = 0;
+            slot->duration.max_us = slot->jitter.max_us = 0;
+            slot->duration.sum_us = slot->jitter.sum_us = 0;
+            __atomic_store_n(&slot->timer_id, 0, __ATOMIC_RELEASE);
+        }
+    }
 }
 
 // ================ TIMER CALLBACKS ================
 
 void performance_test_callback(TimerHandle_t timer) {
-    uint32_t start_time = esp_timer_get_time();
+    int64_t start_time = esp_timer_get_time();
     uint32_t timer_id = (uint32_t)pvTimerGetTimerID(timer);
     
     // Simulate variable processing time
@@ -268,31 +994,10 @@ void performance_test_callback(TimerHandle_t timer) {
         // Simulate work
     }
     
-    uint32_t end_time = esp_timer_get_time();
-    uint32_t duration_us = end_time - start_time;
-    
-    // Check accuracy (simplified)
-    static uint32_t last_callback_time = 0;
+    uint32_t duration_us = esp_timer_get_time() - start_time;
     uint32_t expected_interval = pdTICKS_TO_MS(xTimerGetPeriod(timer)) * 1000; // Convert to μs
-    uint32_t actual_interval = start_time - last_callback_time;
-    bool accuracy_ok = true;
-    
-    if (last_callback_time > 0) {
-        uint32_t accuracy_percent = (actual_interval * 100) / expected_interval;
-        accuracy_ok = (accuracy_percent >= 95 && accuracy_percent <= 105);
-    }
     
-    last_callback_time = start_time;
-    
-    record_performance_sample(timer_id, duration_us, accuracy_ok);
-    
-    // Update timer stats
-    for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-        if (timer_pool[i].in_use && timer_pool[i].id == timer_id) {
-            timer_pool[i].callback_count++;
-            break;
-        }
-    }
+    record_performance_sample(timer_id, start_time, duration_us, expected_interval);
 }
 
 void stress_test_callback(TimerHandle_t timer) {
@@ -306,27 +1011,29 @@ void stress_test_callback(TimerHandle_t timer) {
     }
 }
 
+void control_loop_callback(TimerHandle_t timer) {
+    static uint32_t control_iterations = 0;
+    control_iterations++;
+}
+
+void wheel_control_callback(wheel_timer_t* timer, void* context) {
+    static uint32_t wheel_iterations = 0;
+    wheel_iterations++;
+}
+
 void health_monitor_callback(TimerHandle_t timer) {
     // Update health metrics
     health_data.free_heap_bytes = esp_get_free_heap_size();
     
-    uint32_t active_count = 0;
-    uint32_t pool_used = 0;
-    
-    if (xSemaphoreTake(pool_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        for (int i = 0; i < TIMER_POOL_SIZE; i++) {
-            if (timer_pool[i].in_use) {
-                pool_used++;
-                if (xTimerIsTimerActive(timer_pool[i].handle)) {
-                    active_count++;
-                }
-            }
-        }
-        xSemaphoreGive(pool_mutex);
-    }
+    // Counters only: no pool mutex and no scan on the daemon task
+    uint32_t active_count = __atomic_load_n(&timer_pool_active, __ATOMIC_RELAXED);
+    uint32_t pool_used = __atomic_load_n(&timer_pool_in_use, __ATOMIC_RELAXED);
+    uint32_t pool_slots = __atomic_load_n(&timer_pool_chunk_count, __ATOMIC_RELAXED) *
+                          TIMER_POOL_CHUNK_SIZE;
     
+    // The pool grows on demand, so only the hard cap says how close it is to exhaustion
     health_data.active_timers = active_count;
-    health_data.pool_utilization = (pool_used * 100) / TIMER_POOL_SIZE;
+    health_data.pool_utilization = (pool_used * 100) / TIMER_POOL_CAPACITY;
     health_data.dynamic_timers = dynamic_timer_count;
     
     // Health status LED
@@ -338,7 +1045,8 @@ void health_monitor_callback(TimerHandle_t timer) {
     
     ESP_LOGI(TAG, "🏥 Health Monitor:");
     ESP_LOGI(TAG, "  Active Timers: %lu/%lu", active_count, pool_used);
-    ESP_LOGI(TAG, "  Pool Utilization: %lu%%", health_data.pool_utilization);
+    ESP_LOGI(TAG, "  Pool Utilization: %lu%% of max (%lu/%lu in use, %lu slots grown)",
+             health_data.pool_utilization, pool_used, (uint32_t)TIMER_POOL_CAPACITY, pool_slots);
     ESP_LOGI(TAG, "  Dynamic Timers: %lu/%d", health_data.dynamic_timers, DYNAMIC_TIMER_MAX);
     ESP_LOGI(TAG, "  Free Heap: %lu bytes", health_data.free_heap_bytes);
     ESP_LOGI(TAG, "  Failed Creations: %lu", health_data.failed_creations);
@@ -393,7 +1101,7 @@ void stress_test_task(void *parameter) {
                                             true, stress_test_callback, NULL);
         
         if (stress_timers[i] != NULL) {
-            xTimerStart(stress_timers[i]->handle, 0);
+            pool_timer_start(stress_timers[i]);
         }
         
         vTaskDelay(pdMS_TO_TICKS(100)); // Stagger creation
@@ -405,7 +1113,7 @@ void stress_test_task(void *parameter) {
     // Clean up stress timers
     for (int i = 0; i < 10; i++) {
         if (stress_timers[i] != NULL) {
-            xTimerStop(stress_timers[i]->handle, pdMS_TO_TICKS(100));
+            pool_timer_stop(stress_timers[i]);
             release_to_pool(stress_timers[i]->id);
         }
     }
@@ -427,6 +1135,157 @@ void stress_test_task(void *parameter) {
     vTaskDelete(NULL);
 }
 
+// ================ TIMING WHEEL WORKLOAD ================
+
+static uint32_t wheel_random_timeout(void) {
+    uint32_t span = WHEEL_CONN_MAX_TIMEOUT_MS - WHEEL_CONN_MIN_TIMEOUT_MS;
+    return pdMS_TO_TICKS(WHEEL_CONN_MIN_TIMEOUT_MS + esp_random() % span);
+}
+
+void connection_timeout_callback(wheel_timer_t* timer, void* context) {
+    wheel_connection_t* conn = (wheel_connection_t*)context;
+    
+    // Idle connection dropped; the peer reconnects and the timer is re-armed
+    wheel_connection_timeouts++;
+    conn->keepalives = 0;
+    wheel_timer_start(timer, wheel_random_timeout());
+}
+
+void wheel_tick_noop(wheel_timer_t* timer, void* context) {
+}
+
+static void bench_drain_marker(void* semaphore, uint32_t unused) {
+    xSemaphoreGive((SemaphoreHandle_t)semaphore);
+}
+
+// The daemon does the sorted insert after we queue the command; wait for it
+static void wait_for_timer_daemon(SemaphoreHandle_t done) {
+    xTimerPendFunctionCall(bench_drain_marker, done, 0, portMAX_DELAY);
+    xSemaphoreTake(done, portMAX_DELAY);
+}
+
+static uint32_t bench_ns_per_op(int64_t start_us, uint32_t ops) {
+    return ops ? (uint32_t)((esp_timer_get_time() - start_us) * 1000 / ops) : 0;
+}
+
+// Start/restart/stop cost per timer, wheel vs. FreeRTOS daemon, as CSV rows
+void run_wheel_benchmark(uint32_t count) {
+    wheel_timer_t* wheel_timers = calloc(count, sizeof(wheel_timer_t));
+    TimerHandle_t* handles = calloc(count, sizeof(TimerHandle_t));
+    TickType_t* delays = calloc(count, sizeof(TickType_t));
+    SemaphoreHandle_t done = xSemaphoreCreateBinary();
+    
+    if (!wheel_timers || !handles || !delays || !done) {
+        ESP_LOGW(TAG, "Wheel benchmark: no memory for %lu timers", count);
+        goto cleanup;
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        delays[i] = WHEEL_BENCH_MIN_DELAY + esp_random() % (WHEEL_BENCH_MAX_DELAY - WHEEL_BENCH_MIN_DELAY);
+        wheel_timer_init(&wheel_timers[i], wheel_tick_noop, NULL);
+    }
+    
+    int64_t t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_start(&wheel_timers[i], delays[i]);
+    }
+    uint32_t wheel_start = bench_ns_per_op(t0, count);
+    
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_start(&wheel_timers[i], delays[count - 1 - i]);
+    }
+    uint32_t wheel_restart = bench_ns_per_op(t0, count);
+    
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < count; i++) {
+        wheel_timer_stop(&wheel_timers[i]);
+    }
+    uint32_t wheel_stop = bench_ns_per_op(t0, count);
+    printf("TIMER_BENCH,wheel,%lu,%lu,%lu,%lu\n", count, wheel_start, wheel_restart, wheel_stop);
+    
+    // Same pattern through the daemon; creation is outside the timed phases
+    uint32_t created = 0;
+    while (created < count) {
+        handles[created] = xTimerCreate("Bench", delays[created], pdFALSE, NULL, stress_test_callback);
+        if (!handles[created]) break;
+        created++;
+    }
+    if (created < count) {
+        ESP_LOGW(TAG, "Wheel benchmark: only %lu/%lu FreeRTOS timers fit in heap", created, count);
+    }
+    
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < created; i++) {
+        xTimerStart(handles[i], portMAX_DELAY);
+    }
+    wait_for_timer_daemon(done);
+    uint32_t rtos_start = bench_ns_per_op(t0, created);
+    
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < created; i++) {
+        xTimerChangePeriod(handles[i], delays[created - 1 - i], portMAX_DELAY);
+    }
+    wait_for_timer_daemon(done);
+    uint32_t rtos_restart = bench_ns_per_op(t0, created);
+    
+    t0 = esp_timer_get_time();
+    for (uint32_t i = 0; i < created; i++) {
+        xTimerStop(handles[i], portMAX_DELAY);
+    }
+    wait_for_timer_daemon(done);
+    uint32_t rtos_stop = bench_ns_per_op(t0, created);
+    printf("TIMER_BENCH,freertos,%lu,%lu,%lu,%lu\n", created, rtos_start, rtos_restart, rtos_stop);
+    
+    for (uint32_t i = 0; i < created; i++) {
+        xTimerDelete(handles[i], portMAX_DELAY);
+    }
+    wait_for_timer_daemon(done);
+    
+cleanup:
+    if (done) vSemaphoreDelete(done);
+    free(delays);
+    free(handles);
+    free(wheel_timers);
+}
+
+void wheel_workload_task(void *parameter) {
+    static const uint32_t bench_sizes[] = {100, 1000, WHEEL_CONN_COUNT};
+    
+    ESP_LOGI(TAG, "⏱️ Timing wheel benchmark (ns per operation)");
+    printf("TIMER_BENCH,backend,timers,start_ns,restart_ns,stop_ns\n");
+    for (int i = 0; i < sizeof(bench_sizes) / sizeof(bench_sizes[0]); i++) {
+        run_wheel_benchmark(bench_sizes[i]);
+    }
+    
+    // Connection-timeout workload: every connection holds an armed one-shot
+    uint32_t conn_count = WHEEL_CONN_COUNT;
+    wheel_connection_t* connections = NULL;
+    while (conn_count > 0 && (connections = calloc(conn_count, sizeof(wheel_connection_t))) == NULL) {
+        conn_count /= 2;
+    }
+    if (!connections) {
+        ESP_LOGE(TAG, "No memory for connection workload");
+        vTaskDelete(NULL);
+    }
+    
+    for (uint32_t i = 0; i < conn_count; i++) {
+        wheel_timer_init(&connections[i].timeout, connection_timeout_callback, &connections[i]);
+        wheel_timer_start(&connections[i].timeout, wheel_random_timeout());
+    }
+    ESP_LOGI(TAG, "⏱️ %lu connection timeouts armed on the wheel", conn_count);
+    
+    while (1) {
+        // Traffic on random connections pushes their timeout back
+        for (int i = 0; i < WHEEL_CONN_KEEPALIVES; i++) {
+            wheel_connection_t* conn = &connections[esp_random() % conn_count];
+            conn->keepalives++;
+            wheel_timer_start(&conn->timeout, wheel_random_timeout());
+        }
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+}
+
 // ================ PERFORMANCE ANALYSIS TASK ================
 
 void performance_analysis_task(void *parameter) {
@@ -436,6 +1295,8 @@ void performance_analysis_task(void *parameter) {
         vTaskDelay(pdMS_TO_TICKS(10000)); // Every 10 seconds
         
         analyze_performance();
+        print_deadline_report();
+        export_latency_histograms();
         
         // Generate performance report
         ESP_LOGI(TAG, "\n═══ PERFORMANCE REPORT ═══");
@@ -445,6 +1306,7 @@ void performance_analysis_task(void *parameter) {
         ESP_LOGI(TAG, "Average Accuracy: %.1f%%", health_data.average_accuracy);
         ESP_LOGI(TAG, "Callback Overruns: %lu", health_data.callback_overruns);
         ESP_LOGI(TAG, "Command Failures: %lu", health_data.command_failures);
+        print_wheel_stats();
         ESP_LOGI(TAG, "═════════════════════════\n");
         
         // Memory usage check
@@ -472,12 +1334,8 @@ void init_hardware(void) {
 }
 
 void init_monitoring(void) {
-    perf_mutex = xSemaphoreCreateMutex();
     test_result_queue = xQueueCreate(20, sizeof(uint32_t));
     
-    // Clear performance buffer
-    memset(perf_buffer, 0, sizeof(perf_buffer));
-    
     ESP_LOGI(TAG, "Monitoring systems initialized");
 }
 
@@ -503,6 +1361,20 @@ void create_system_timers(void) {
     } else {
         ESP_LOGE(TAG, "Failed to create system timers");
     }
+    
+    // Periodic control loops on each backend, watched by the deadline report
+    timer_pool_entry_t* control = allocate_from_pool("CtrlLoop",
+                                                     pdMS_TO_TICKS(CONTROL_LOOP_PERIOD_MS),
+                                                     true, control_loop_callback, NULL);
+    timer_pool_entry_t* wheel_control = allocate_wheel_from_pool("WheelLoop",
+                                                                 pdMS_TO_TICKS(WHEEL_LOOP_PERIOD_MS),
+                                                                 true, wheel_control_callback, NULL);
+    if (control) {
+        pool_timer_start(control);
+    }
+    if (wheel_control) {
+        pool_timer_start(wheel_control);
+    }
 }
 
 void app_main(void) {
@@ -512,6 +1384,7 @@ void app_main(void) {
     init_hardware();
     init_timer_pool();
     init_monitoring();
+    init_timing_wheel();
     create_system_timers();
     
     // Create analysis task
@@ -520,6 +1393,7 @@ void app_main(void) {
     // Wait a bit then start stress test
     vTaskDelay(pdMS_TO_TICKS(5000));
     xTaskCreate(stress_test_task, "StressTest", 2048, NULL, 5, &stress_test_task_handle);
+    xTaskCreate(wheel_workload_task, "WheelLoad", 3072, NULL, 4, NULL);
     
     ESP_LOGI(TAG, "🚀 Advanced Timer Management System Running");
     ESP_LOGI(TAG, "Monitor LEDs for system status:");
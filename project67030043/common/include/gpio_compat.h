@@ -0,0 +1,19 @@
+#pragma once
+
+#include "sdkconfig.h"
+
+#ifdef CONFIG_IDF_TARGET_LINUX
+// Host build (idf.py --preview set-target linux) has no GPIO peripheral,
+// so LED writes become no-ops and the benchmarks run unchanged
+typedef int gpio_num_t;
+#define GPIO_NUM_2   2
+#define GPIO_NUM_4   4
+#define GPIO_NUM_5   5
+#define GPIO_NUM_18  18
+#define GPIO_NUM_19  19
+#define GPIO_MODE_OUTPUT 0
+#define gpio_set_direction(pin, mode) ((void)(pin), (void)(mode))
+#define gpio_set_level(pin, level)    ((void)(pin), (void)(level))
+#else
+#include "driver/gpio.h"
+#endif
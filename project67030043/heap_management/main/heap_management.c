@@ -10,7 +10,13 @@
 #include "esp_heap_caps.h"
 #include "esp_timer.h"
 #include "esp_system.h"
-#include "driver/gpio.h"
+#include "esp_idf_version.h"
+
+#include "gpio_compat.h"
+#ifndef CONFIG_IDF_TARGET_LINUX
+#include "esp_cpu.h"
+#include "esp_memory_utils.h"
+#endif
 
 static const char *TAG = "HEAP_MGMT";
 
@@ -25,7 +31,54 @@ static const char *TAG = "HEAP_MGMT";
 #define LOW_MEMORY_THRESHOLD    50000    // 50KB
 #define CRITICAL_MEMORY_THRESHOLD 20000  // 20KB
 #define FRAGMENTATION_THRESHOLD 0.3      // 30% fragmentation
-#define MAX_ALLOCATIONS         100
+#define MAX_ALLOCATIONS         1024
+
+// Pointer hash index: open addressing, linear probing, kept at most half full
+#define ALLOC_INDEX_BITS        11
+#define ALLOC_INDEX_SIZE        (1 << ALLOC_INDEX_BITS)
+
+_Static_assert(ALLOC_INDEX_SIZE >= 2 * MAX_ALLOCATIONS, "allocation index load factor above 0.5");
+_Static_assert(MAX_ALLOCATIONS < UINT16_MAX, "slot numbers are stored as uint16_t");
+
+// Deferred allocation logging
+#define ALLOC_LOG_RING_SIZE     64     // pending events; extras are counted and dropped
+#define ALLOC_LOG_DESC_LEN      16     // description bytes copied per event
+#define ALLOC_LOG_TASK_PRIORITY 1
+
+// Tracker overhead benchmark (tracked_malloc/free vs raw heap_caps_malloc/free)
+#define TRACKING_BENCH_ALLOCS   512    // live allocations per round
+#define TRACKING_BENCH_ROUNDS   8
+
+#define SUMMARY_MAX_LISTED      20     // active allocations printed per summary
+
+// Sampling heap profiler: stays on when full tracking is switched off
+#define HEAP_SAMPLE_INTERVAL_BYTES  4096   // mean bytes allocated between samples
+#define HEAP_SAMPLE_TABLE_BITS      9      // 512 buckets
+#define HEAP_SAMPLE_MAX_LIVE        256    // keeps the table at most half full
+#define HEAP_PROFILE_PERIOD_MS      60000  // profile dump interval
+#define HEAP_PROFILE_HEX_PER_LINE   32
+
+// Epoch leak tracking
+#define LEAK_SITE_BITS          7      // 128 buckets keyed by call site
+#define LEAK_MAX_SITES          96     // keeps the table under 75% full
+#define LEAK_GROWTH_EPOCHS      3      // consecutive growing epochs before a site is reported
+#define LEAK_REPORT_MAX         8
+#define LEAK_NO_SITE            0xFFFF
+
+// Placement policy
+#define PLACEMENT_LARGE_SIZE    4096   // warm data this big prefers SPIRAM unless short-lived
+
+// Fragmentation tracking
+#define FRAG_HIST_BUCKETS       16     // power-of-two classes: <32, 32-63, ... , >=512K
+#define FRAG_HIST_MIN_SHIFT     4      // smallest class starts at 16 bytes
+#define FRAG_REBUILD_MS         2000   // exact heap walk that corrects the incremental model
+#define FRAG_SHED_BLOCK_SIZE    1536   // one network packet; shed load before losing this
+
+// Request-scoped arenas
+#define ARENA_CHUNK_SIZE        4096   // default bytes per chunk taken from the heap
+#define ARENA_DEFAULT_ALIGN     8      // covers uint64_t and double
+#define ARENA_BENCH_MESSAGES    200
+#define ARENA_BENCH_ALLOCS      32     // small allocations per message
 
 // Memory allocation tracking
 typedef struct {
@@ -34,6 +87,8 @@ typedef struct {
     uint32_t caps;
     const char* description;
     uint64_t timestamp;
+    uint32_t generation;   // Leak epoch the allocation was made in
+    uint16_t site;         // leak_sites[] bucket, LEAK_NO_SITE if untracked
     bool is_active;
 } memory_allocation_t;
 
@@ -56,28 +111,705 @@ static memory_stats_t stats = {0};
 static SemaphoreHandle_t memory_mutex;
 static bool memory_monitoring_enabled = true;
 
+// Tracker index (all guarded by memory_mutex)
+static uint16_t alloc_index[ALLOC_INDEX_SIZE];    // slot + 1, 0 = empty bucket
+static uint16_t free_slots[MAX_ALLOCATIONS];      // stack of unused slots
+static int free_slot_count = 0;
+
+// Deferred log: tracked_malloc/free queue events, the log task prints them
+typedef enum {
+    ALLOC_EVENT_ALLOC = 0,
+    ALLOC_EVENT_FREE,
+    ALLOC_EVENT_FAILED,
+    ALLOC_EVENT_TRACKING_FULL,
+    ALLOC_EVENT_UNTRACKED_FREE
+} alloc_event_type_t;
+
+typedef struct {
+    uint8_t type;
+    int16_t slot;
+    size_t size;
+    void* ptr;
+    char description[ALLOC_LOG_DESC_LEN];
+} alloc_log_event_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    alloc_log_event_t events[ALLOC_LOG_RING_SIZE];
+    uint32_t head;         // Next write (free-running)
+    uint32_t tail;         // Next read (free-running)
+    uint32_t dropped;
+    TaskHandle_t task;
+} alloc_log_ring_t;
+
+static alloc_log_ring_t alloc_log = {
+    .lock = portMUX_INITIALIZER_UNLOCKED
+};
+static bool alloc_event_logging = true;
+
+static void alloc_log_post(alloc_event_type_t type, void* ptr, size_t size, int slot,
+                           const char* description) {
+    if (!alloc_event_logging) return;
+    
+    bool was_empty;
+    
+    portENTER_CRITICAL(&alloc_log.lock);
+    if (alloc_log.head - alloc_log.tail >= ALLOC_LOG_RING_SIZE) {
+        alloc_log.dropped++;
+        portEXIT_CRITICAL(&alloc_log.lock);
+        return;
+    }
+    was_empty = (alloc_log.head == alloc_log.tail);
+    alloc_log_event_t* event = &alloc_log.events[alloc_log.head % ALLOC_LOG_RING_SIZE];
+    event->type = type;
+    event->slot = slot;
+    event->size = size;
+    event->ptr = ptr;
+    // Copied: callers may pass descriptions that live on their stack
+    strncpy(event->description, description ? description : "?", ALLOC_LOG_DESC_LEN - 1);
+    event->description[ALLOC_LOG_DESC_LEN - 1] = '\0';
+    alloc_log.head++;
+    portEXIT_CRITICAL(&alloc_log.lock);
+    
+    if (was_empty && alloc_log.task) {
+        xTaskNotifyGive(alloc_log.task);
+    }
+}
+
+void allocation_log_task(void *pvParameters) {
+    uint32_t reported_drops = 0;
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        while (1) {
+            alloc_log_event_t event;
+            
+            portENTER_CRITICAL(&alloc_log.lock);
+            if (alloc_log.tail == alloc_log.head) {
+                portEXIT_CRITICAL(&alloc_log.lock);
+                break;
+            }
+            event = alloc_log.events[alloc_log.tail % ALLOC_LOG_RING_SIZE];
+            alloc_log.tail++;
+            portEXIT_CRITICAL(&alloc_log.lock);
+            
+            switch (event.type) {
+                case ALLOC_EVENT_ALLOC:
+                    ESP_LOGI(TAG, "✅ Allocated %d bytes at %p (%s) - Slot %d", 
+                             event.size, event.ptr, event.description, event.slot);
+                    break;
+                case ALLOC_EVENT_FREE:
+                    ESP_LOGI(TAG, "🗑️ Freed %d bytes at %p (%s) - Slot %d", 
+                             event.size, event.ptr, event.description, event.slot);
+                    break;
+                case ALLOC_EVENT_FAILED:
+                    ESP_LOGE(TAG, "❌ Failed to allocate %d bytes (%s)", 
+                             event.size, event.description);
+                    break;
+                case ALLOC_EVENT_TRACKING_FULL:
+                    ESP_LOGW(TAG, "⚠️ Allocation tracking full!");
+                    break;
+                case ALLOC_EVENT_UNTRACKED_FREE:
+                    ESP_LOGW(TAG, "⚠️ Freeing untracked pointer %p (%s)", 
+                             event.ptr, event.description);
+                    break;
+            }
+        }
+        
+        if (alloc_log.dropped != reported_drops) {
+            ESP_LOGW(TAG, "⚠️ %lu allocation log events dropped", 
+                     alloc_log.dropped - reported_drops);
+            reported_drops = alloc_log.dropped;
+        }
+    }
+}
+
 // Memory monitoring functions
-int find_free_allocation_slot(void) {
+static inline uint32_t pointer_hash(const void* ptr, int bits) {
+    // Fibonacci hashing; heap pointers are at least 4-byte aligned
+    return ((uint32_t)((uintptr_t)ptr >> 2) * 2654435761u) >> (32 - bits);
+}
+
+static inline uint32_t alloc_index_hash(const void* ptr) {
+    return pointer_hash(ptr, ALLOC_INDEX_BITS);
+}
+
+void init_allocation_tracking(void) {
+    memset(allocations, 0, sizeof(allocations));
+    memset(alloc_index, 0, sizeof(alloc_index));
+    
+    // Lowest slot on top so slots fill in order, like the old linear scan
     for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-        if (!allocations[i].is_active) {
-            return i;
-        }
+        free_slots[i] = MAX_ALLOCATIONS - 1 - i;
     }
-    return -1;
+    free_slot_count = MAX_ALLOCATIONS;
+}
+
+int find_free_allocation_slot(void) {
+    if (free_slot_count == 0) {
+        return -1;
+    }
+    return free_slots[--free_slot_count];
+}
+
+static void release_allocation_slot(int slot) {
+    free_slots[free_slot_count++] = slot;
 }
 
 int find_allocation_by_ptr(void* ptr) {
-    for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-        if (allocations[i].is_active && allocations[i].ptr == ptr) {
-            return i;
+    for (uint32_t b = alloc_index_hash(ptr); alloc_index[b]; b = (b + 1) & (ALLOC_INDEX_SIZE - 1)) {
+        int slot = alloc_index[b] - 1;
+        if (allocations[slot].ptr == ptr) {
+            return slot;
         }
     }
     return -1;
 }
 
-void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
+static void alloc_index_insert(void* ptr, int slot) {
+    uint32_t b = alloc_index_hash(ptr);
+    while (alloc_index[b]) {
+        b = (b + 1) & (ALLOC_INDEX_SIZE - 1);
+    }
+    alloc_index[b] = slot + 1;
+}
+
+// Backward-shift delete keeps probe chains intact without tombstones
+static void alloc_index_remove(void* ptr) {
+    uint32_t mask = ALLOC_INDEX_SIZE - 1;
+    uint32_t b = alloc_index_hash(ptr);
+    
+    while (alloc_index[b] && allocations[alloc_index[b] - 1].ptr != ptr) {
+        b = (b + 1) & mask;
+    }
+    if (!alloc_index[b]) return;
+    
+    uint32_t hole = b;
+    for (uint32_t next = (b + 1) & mask; alloc_index[next]; next = (next + 1) & mask) {
+        uint32_t home = alloc_index_hash(allocations[alloc_index[next] - 1].ptr);
+        // Move the entry back unless its home lies cyclically in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            alloc_index[hole] = alloc_index[next];
+            hole = next;
+        }
+    }
+    alloc_index[hole] = 0;
+}
+
+// Live bytes per allocation call site, compared across epochs. Every
+// tracked allocation is stamped with the epoch it was made in; a site that
+// changes is queued once per epoch, so leak_epoch_checkpoint() only visits
+// sites that saw traffic since the last checkpoint, however many
+// allocations are live. All guarded by memory_mutex.
+typedef struct {
+    uint32_t caller;           // Return address, 0 = empty bucket
+    char description[ALLOC_LOG_DESC_LEN];
+    uint32_t live_bytes;
+    uint32_t live_count;
+    uint32_t baseline_bytes;   // live_bytes at the previous checkpoint
+    uint32_t retained_bytes;   // Allocated this epoch and still live
+    uint32_t queued_epoch;     // Epoch in which it was last put on leak_changed
+    uint32_t growth_epoch;     // Last epoch that ended with growth
+    uint16_t growth_streak;
+} leak_site_t;
+
+typedef struct {
+    uint32_t caller;
+    char description[ALLOC_LOG_DESC_LEN];
+    uint32_t live_bytes;
+    uint32_t growth_bytes;
+    uint32_t retained_bytes;
+    uint16_t growth_streak;
+} leak_suspect_t;
+
+static leak_site_t leak_sites[1 << LEAK_SITE_BITS];
+static uint16_t leak_changed[LEAK_MAX_SITES];
+static int leak_changed_count = 0;
+static int leak_site_count = 0;
+static uint32_t leak_epoch = 1;            // 0 is the queued_epoch of an untouched site
+static uint32_t leak_untracked_allocs = 0; // Site table was full
+
+static int leak_site_lookup(uint32_t caller, const char* description) {
+    const uint32_t mask = (1 << LEAK_SITE_BITS) - 1;
+    uint32_t b = pointer_hash((const void*)(uintptr_t)caller, LEAK_SITE_BITS);
+    
+    while (leak_sites[b].caller && leak_sites[b].caller != caller) {
+        b = (b + 1) & mask;
+    }
+    
+    if (!leak_sites[b].caller) {
+        if (leak_site_count >= LEAK_MAX_SITES) {
+            leak_untracked_allocs++;
+            return -1;
+        }
+        leak_sites[b].caller = caller;
+        strncpy(leak_sites[b].description, description ? description : "?",
+                ALLOC_LOG_DESC_LEN - 1);
+        leak_site_count++;
+    }
+    
+    return b;
+}
+
+static inline void leak_site_touch(int site) {
+    if (leak_sites[site].queued_epoch != leak_epoch) {
+        leak_sites[site].queued_epoch = leak_epoch;
+        leak_changed[leak_changed_count++] = site;
+    }
+}
+
+static void leak_note_alloc(int slot, uint32_t caller) {
+    int site = leak_site_lookup(caller, allocations[slot].description);
+    
+    allocations[slot].generation = leak_epoch;
+    allocations[slot].site = (site >= 0) ? site : LEAK_NO_SITE;
+    if (site < 0) return;
+    
+    leak_sites[site].live_bytes += allocations[slot].size;
+    leak_sites[site].live_count++;
+    leak_sites[site].retained_bytes += allocations[slot].size;
+    leak_site_touch(site);
+}
+
+static void leak_note_free(int slot) {
+    int site = allocations[slot].site;
+    if (site == LEAK_NO_SITE) return;
+    
+    leak_sites[site].live_bytes -= allocations[slot].size;
+    leak_sites[site].live_count--;
+    if (allocations[slot].generation == leak_epoch) {
+        leak_sites[site].retained_bytes -= allocations[slot].size;
+    }
+    leak_site_touch(site);
+}
+
+// Close the current epoch. Call at points where the application should be
+// in steady state; returns the number of sites that kept growing.
+int leak_epoch_checkpoint(void) {
+    leak_suspect_t suspects[LEAK_REPORT_MAX];
+    int suspect_count = 0;
+    int changed = 0;
+    uint32_t epoch = 0;
+    
+    if (!memory_mutex || xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        return 0;
+    }
+    
+    epoch = leak_epoch;
+    changed = leak_changed_count;
+    
+    for (int i = 0; i < leak_changed_count; i++) {
+        leak_site_t* site = &leak_sites[leak_changed[i]];
+        
+        if (site->live_bytes > site->baseline_bytes) {
+            // Streaks reset lazily: an epoch without growth leaves growth_epoch behind
+            site->growth_streak = (site->growth_epoch == epoch - 1) ? site->growth_streak + 1 : 1;
+            site->growth_epoch = epoch;
+            
+            if (site->growth_streak >= LEAK_GROWTH_EPOCHS && suspect_count < LEAK_REPORT_MAX) {
+                leak_suspect_t* s = &suspects[suspect_count++];
+                s->caller = site->caller;
+                memcpy(s->description, site->description, ALLOC_LOG_DESC_LEN);
+                s->live_bytes = site->live_bytes;
+                s->growth_bytes = site->live_bytes - site->baseline_bytes;
+                s->retained_bytes = site->retained_bytes;
+                s->growth_streak = site->growth_streak;
+            }
+        }
+        
+        site->baseline_bytes = site->live_bytes;
+        site->retained_bytes = 0;
+    }
+    
+    leak_changed_count = 0;
+    leak_epoch++;
+    
+    xSemaphoreGive(memory_mutex);
+    
+    ESP_LOGI(TAG, "🔍 Epoch %lu closed: %d sites changed", epoch, changed);
+    for (int i = 0; i < suspect_count; i++) {
+        ESP_LOGW(TAG, "GROWING SITE 0x%08lx (%s): %lu bytes live, +%lu this epoch, "
+                 "%lu retained from it, growing %u epochs",
+                 suspects[i].caller, suspects[i].description, suspects[i].live_bytes,
+                 suspects[i].growth_bytes, suspects[i].retained_bytes, suspects[i].growth_streak);
+    }
+    
+    return suspect_count;
+}
+
+// Sampled allocations, keyed by pointer (open addressing, empty = NULL ptr)
+typedef struct {
+    void* ptr;
+    uint32_t caller;       // Return address into the allocating function
+    uint32_t size;
+} heap_sample_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    heap_sample_t table[1 << HEAP_SAMPLE_TABLE_BITS];
+    uint32_t live;
+    int32_t countdown;     // Bytes left until the next sample
+    uint32_t samples;
+    uint32_t dropped;      // Sampled while the table was full
+} heap_sampler_t;
+
+static heap_sampler_t heap_sampler = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+    .countdown = HEAP_SAMPLE_INTERVAL_BYTES
+};
+
+// Exponentially distributed gap with mean HEAP_SAMPLE_INTERVAL_BYTES, so
+// every byte has the same chance of being sampled (as in tcmalloc)
+static int32_t heap_sample_next_interval(void) {
+    float u = ((esp_random() >> 8) + 1) / 16777216.0f;   // (0, 1]
+    float gap = -logf(u) * HEAP_SAMPLE_INTERVAL_BYTES;
+    if (gap < 1.0f) gap = 1.0f;
+    if (gap > 16.0f * HEAP_SAMPLE_INTERVAL_BYTES) gap = 16.0f * HEAP_SAMPLE_INTERVAL_BYTES;
+    return (int32_t)gap;
+}
+
+// The allocation that reaches zero is sampled and re-arms the countdown with
+// a fresh gap, so it never stays negative; one larger than the remaining gap
+// is therefore always sampled
+static inline bool heap_sample_due(size_t size) {
+    int32_t left = __atomic_load_n(&heap_sampler.countdown, __ATOMIC_RELAXED);
+    int32_t gap = 0;
+    int32_t next;
+    
+    do {
+        if (left > (int32_t)size) {
+            next = left - (int32_t)size;
+        } else {
+            if (gap == 0) gap = heap_sample_next_interval();
+            next = gap;
+        }
+    } while (!__atomic_compare_exchange_n(&heap_sampler.countdown, &left, next, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    
+    return left <= (int32_t)size;
+}
+
+static void heap_sample_record(void* ptr, size_t size, uint32_t caller) {
+    const uint32_t mask = (1 << HEAP_SAMPLE_TABLE_BITS) - 1;
+    
+    portENTER_CRITICAL(&heap_sampler.lock);
+    if (heap_sampler.live >= HEAP_SAMPLE_MAX_LIVE) {
+        heap_sampler.dropped++;
+    } else {
+        uint32_t b = pointer_hash(ptr, HEAP_SAMPLE_TABLE_BITS);
+        while (heap_sampler.table[b].ptr) {
+            b = (b + 1) & mask;
+        }
+        heap_sampler.table[b].ptr = ptr;
+        heap_sampler.table[b].caller = caller;
+        heap_sampler.table[b].size = size;
+        heap_sampler.live++;
+        heap_sampler.samples++;
+    }
+    portEXIT_CRITICAL(&heap_sampler.lock);
+}
+
+static void heap_sample_forget(void* ptr) {
+    const uint32_t mask = (1 << HEAP_SAMPLE_TABLE_BITS) - 1;
+    
+    if (__atomic_load_n(&heap_sampler.live, __ATOMIC_RELAXED) == 0) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&heap_sampler.lock);
+    uint32_t b = pointer_hash(ptr, HEAP_SAMPLE_TABLE_BITS);
+    while (heap_sampler.table[b].ptr && heap_sampler.table[b].ptr != ptr) {
+        b = (b + 1) & mask;
+    }
+    if (heap_sampler.table[b].ptr) {
+        // Backward-shift delete, same rule as alloc_index_remove()
+        uint32_t hole = b;
+        for (uint32_t next = (b + 1) & mask; heap_sampler.table[next].ptr; next = (next + 1) & mask) {
+            uint32_t home = pointer_hash(heap_sampler.table[next].ptr, HEAP_SAMPLE_TABLE_BITS);
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                heap_sampler.table[hole] = heap_sampler.table[next];
+                hole = next;
+            }
+        }
+        heap_sampler.table[hole].ptr = NULL;
+        heap_sampler.live--;
+    }
+    portEXIT_CRITICAL(&heap_sampler.lock);
+}
+
+// Free-block histogram per caps region. tracked_malloc/tracked_free keep it
+// current with an estimate of how the allocator splits and releases blocks;
+// heap_frag_monitor_task replaces the estimate with a real heap walk every
+// FRAG_REBUILD_MS. Readers never block: the snapshot is published under a
+// sequence counter (odd = being written) and copied until it reads stable.
+typedef enum {
+    FRAG_REGION_INTERNAL = 0,
+    FRAG_REGION_SPIRAM,
+    FRAG_REGION_DMA,
+    FRAG_REGION_MAX
+} frag_region_t;
+
+static const uint32_t frag_region_caps[FRAG_REGION_MAX] = {
+    MALLOC_CAP_INTERNAL, MALLOC_CAP_SPIRAM, MALLOC_CAP_DMA
+};
+static const char* frag_region_names[FRAG_REGION_MAX] = {"INTERNAL", "SPIRAM", "DMA"};
+
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t free_blocks;
+    uint32_t largest_block;    // Lower bound between heap walks
+    uint32_t histogram[FRAG_HIST_BUCKETS];
+    float fragmentation;       // 1 - largest / free
+    uint32_t updates;          // Incremental updates since the last walk
+    uint64_t walked_at_us;
+} frag_snapshot_t;
+
+typedef struct {
+    portMUX_TYPE lock;         // Serializes writers only
+    uint32_t seq;
+    frag_snapshot_t snap;
+} frag_region_state_t;
+
+static frag_region_state_t frag_regions[FRAG_REGION_MAX] = {
+    {.lock = portMUX_INITIALIZER_UNLOCKED},
+    {.lock = portMUX_INITIALIZER_UNLOCKED},
+    {.lock = portMUX_INITIALIZER_UNLOCKED}
+};
+
+static inline int frag_bucket(size_t size) {
+    if (size < (2u << FRAG_HIST_MIN_SHIFT)) return 0;
+    int b = 31 - __builtin_clz(size) - FRAG_HIST_MIN_SHIFT;
+    return (b < FRAG_HIST_BUCKETS) ? b : FRAG_HIST_BUCKETS - 1;
+}
+
+static inline void frag_add_block(frag_snapshot_t* snap, size_t size) {
+    snap->histogram[frag_bucket(size)]++;
+    snap->free_blocks++;
+    if (size > snap->largest_block) snap->largest_block = size;
+}
+
+static inline void frag_finish(frag_snapshot_t* snap) {
+    snap->fragmentation = (snap->free_bytes > 0) ?
+        1.0f - (float)snap->largest_block / (float)snap->free_bytes : 0.0f;
+}
+
+// Writers hold region->lock around begin/end
+static inline void frag_publish_begin(frag_region_state_t* region) {
+    __atomic_store_n(&region->seq, region->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void frag_publish_end(frag_region_state_t* region) {
+    __atomic_store_n(&region->seq, region->seq + 1, __ATOMIC_RELEASE);
+}
+
+static uint32_t frag_regions_for_ptr(const void* ptr) {
+#ifdef CONFIG_IDF_TARGET_LINUX
+    return 1u << FRAG_REGION_INTERNAL;
+#else
+    if (esp_ptr_external_ram(ptr)) {
+        return 1u << FRAG_REGION_SPIRAM;
+    }
+    uint32_t mask = 1u << FRAG_REGION_INTERNAL;
+    if (esp_ptr_dma_capable(ptr)) {
+        mask |= 1u << FRAG_REGION_DMA;
+    }
+    return mask;
+#endif
+}
+
+// Model an allocation: the allocator takes the smallest class that surely
+// fits and splits it; if only the largest block fits, carve from that
+static void frag_model_alloc(frag_snapshot_t* snap, size_t size) {
+    int largest_bucket = frag_bucket(snap->largest_block);
+    int b = frag_bucket(size) + 1;
+    uint32_t block;
+    
+    while (b < largest_bucket && snap->histogram[b] == 0) {
+        b++;
+    }
+    
+    if (b >= largest_bucket) {
+        b = largest_bucket;
+        block = snap->largest_block;
+        uint32_t remaining = (block > size) ? block - size : 0;
+        uint32_t same_class = (snap->histogram[b] > 1) ? (1u << (b + FRAG_HIST_MIN_SHIFT)) : 0;
+        snap->largest_block = (remaining > same_class) ? remaining : same_class;
+    } else {
+        block = 1u << (b + FRAG_HIST_MIN_SHIFT);
+    }
+    
+    if (snap->histogram[b] > 0) {
+        snap->histogram[b]--;
+        snap->free_blocks--;
+    }
+    if (block > size + (1u << FRAG_HIST_MIN_SHIFT)) {
+        snap->histogram[frag_bucket(block - size)]++;
+        snap->free_blocks++;
+    }
+}
+
+// Model a free without coalescing, which can only understate the largest
+// block until the next walk: the safe side for load shedding
+static void heap_frag_note(const void* ptr, size_t size, bool is_alloc) {
+    uint32_t mask = frag_regions_for_ptr(ptr);
+    
+    for (int r = 0; r < FRAG_REGION_MAX; r++) {
+        if (!(mask & (1u << r))) continue;
+        
+        frag_region_state_t* region = &frag_regions[r];
+        size_t free_bytes = heap_caps_get_free_size(frag_region_caps[r]);
+        
+        portENTER_CRITICAL(&region->lock);
+        frag_publish_begin(region);
+        if (is_alloc) {
+            frag_model_alloc(&region->snap, size);
+        } else {
+            frag_add_block(&region->snap, size);
+        }
+        region->snap.free_bytes = free_bytes;
+        region->snap.updates++;
+        frag_finish(&region->snap);
+        frag_publish_end(region);
+        portEXIT_CRITICAL(&region->lock);
+    }
+}
+
+#if !defined(CONFIG_IDF_TARGET_LINUX) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+// Runs with the heap locked: no allocation or logging in here
+static bool frag_walk_block(walker_heap_into_t heap_info, walker_block_info_t block_info, void* user_data) {
+    if (!block_info.used) {
+        frag_snapshot_t* snap = (frag_snapshot_t*)user_data;
+        frag_add_block(snap, block_info.size);
+        snap->free_bytes += block_info.size;
+    }
+    return true;
+}
+#endif
+
+void heap_frag_rebuild(frag_region_t r) {
+    frag_snapshot_t fresh = {0};
+    
+#if !defined(CONFIG_IDF_TARGET_LINUX) && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+    heap_caps_walk(frag_region_caps[r], frag_walk_block, &fresh);
+#else
+    // No block walker: place the largest block exactly and spread the rest evenly
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, frag_region_caps[r]);
+    fresh.free_bytes = info.total_free_bytes;
+    if (info.free_blocks > 0) {
+        frag_add_block(&fresh, info.largest_free_block);
+        if (info.free_blocks > 1) {
+            size_t rest = info.total_free_bytes - info.largest_free_block;
+            fresh.histogram[frag_bucket(rest / (info.free_blocks - 1))] += info.free_blocks - 1;
+            fresh.free_blocks = info.free_blocks;
+        }
+    }
+#endif
+    fresh.walked_at_us = esp_timer_get_time();
+    frag_finish(&fresh);
+    
+    frag_region_state_t* region = &frag_regions[r];
+    portENTER_CRITICAL(&region->lock);
+    frag_publish_begin(region);
+    region->snap = fresh;
+    frag_publish_end(region);
+    portEXIT_CRITICAL(&region->lock);
+}
+
+// Lock-free O(1) read of a consistent snapshot
+void heap_frag_read(frag_region_t r, frag_snapshot_t* out) {
+    const frag_region_state_t* region = &frag_regions[r];
+    uint32_t before, after;
+    
+    do {
+        before = __atomic_load_n(&region->seq, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+        *out = region->snap;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&region->seq, __ATOMIC_RELAXED);
+    } while ((before & 1) || before != after);
+}
+
+// Single word load, cheap enough for every request on a hot path
+static inline bool heap_frag_can_allocate(frag_region_t r, size_t size) {
+    return __atomic_load_n(&frag_regions[r].snap.largest_block, __ATOMIC_RELAXED) >= size;
+}
+
+void print_fragmentation_histogram(void) {
+    ESP_LOGI(TAG, "\n🧩 ═══ FREE BLOCK HISTOGRAM ═══");
+    
+    for (int r = 0; r < FRAG_REGION_MAX; r++) {
+        frag_snapshot_t snap;
+        heap_frag_read(r, &snap);
+        if (snap.free_bytes == 0) continue;
+        
+        ESP_LOGI(TAG, "%s: %lu bytes in %lu blocks, largest %lu, fragmentation %.1f%% (%lu updates since walk)",
+                 frag_region_names[r], snap.free_bytes, snap.free_blocks, snap.largest_block,
+                 snap.fragmentation * 100, snap.updates);
+        for (int b = 0; b < FRAG_HIST_BUCKETS; b++) {
+            if (snap.histogram[b] == 0) continue;
+            ESP_LOGI(TAG, "  %s%6u: %lu", (b == 0) ? "<" : ">=",
+                     (b == 0) ? (2u << FRAG_HIST_MIN_SHIFT) : (1u << (b + FRAG_HIST_MIN_SHIFT)),
+                     snap.histogram[b]);
+        }
+    }
+    
+    ESP_LOGI(TAG, "═══════════════════════════════");
+}
+
+void heap_frag_monitor_task(void *pvParameters) {
+    ESP_LOGI(TAG, "🧩 Fragmentation monitor started");
+    bool shedding = false;
+    
+    while (1) {
+        for (int r = 0; r < FRAG_REGION_MAX; r++) {
+            heap_frag_rebuild(r);
+        }
+        
+        bool low = !heap_frag_can_allocate(FRAG_REGION_INTERNAL, FRAG_SHED_BLOCK_SIZE);
+        if (low != shedding) {
+            shedding = low;
+            gpio_set_level(LED_FRAGMENTATION, low);
+            if (low) {
+                stats.fragmentation_events++;
+                ESP_LOGW(TAG, "🧩 Largest internal block below %d bytes - shedding load",
+                         FRAG_SHED_BLOCK_SIZE);
+            } else {
+                ESP_LOGI(TAG, "🧩 Internal heap recovered a %d byte block", FRAG_SHED_BLOCK_SIZE);
+            }
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(FRAG_REBUILD_MS));
+    }
+}
+
+static inline uint32_t caller_address(void* return_address) {
+#ifdef CONFIG_IDF_TARGET_LINUX
+    return (uint32_t)(uintptr_t)return_address;
+#else
+    return esp_cpu_process_stack_pc((uint32_t)(uintptr_t)return_address);
+#endif
+}
+
+// Shared by tracked_malloc and placed_malloc; caller is the site to attribute.
+// A quiet attempt that fails leaves no trace, for callers with other regions to try
+static void* tracked_malloc_at(size_t size, uint32_t caps, const char* description,
+                               uint32_t caller, bool quiet) {
     void* ptr = heap_caps_malloc(size, caps);
     
+    if (!ptr && quiet) {
+        return NULL;
+    }
+    
+    if (ptr && heap_sample_due(size)) {
+        heap_sample_record(ptr, size, caller);
+    }
+    if (ptr) {
+        heap_frag_note(ptr, size, true);
+    }
+    
     if (memory_monitoring_enabled && memory_mutex) {
         if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
             if (ptr) {
@@ -89,6 +821,8 @@ void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
                     allocations[slot].description = description;
                     allocations[slot].timestamp = esp_timer_get_time();
                     allocations[slot].is_active = true;
+                    alloc_index_insert(ptr, slot);
+                    leak_note_alloc(slot, caller);
                     
                     stats.total_allocations++;
                     stats.current_allocations++;
@@ -100,14 +834,13 @@ void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
                         stats.peak_usage = current_usage;
                     }
                     
-                    ESP_LOGI(TAG, "✅ Allocated %d bytes at %p (%s) - Slot %d", 
-                             size, ptr, description, slot);
+                    alloc_log_post(ALLOC_EVENT_ALLOC, ptr, size, slot, description);
                 } else {
-                    ESP_LOGW(TAG, "⚠️ Allocation tracking full!");
+                    alloc_log_post(ALLOC_EVENT_TRACKING_FULL, ptr, size, -1, description);
                 }
             } else {
                 stats.allocation_failures++;
-                ESP_LOGE(TAG, "❌ Failed to allocate %d bytes (%s)", size, description);
+                alloc_log_post(ALLOC_EVENT_FAILED, NULL, size, -1, description);
             }
             
             xSemaphoreGive(memory_mutex);
@@ -117,22 +850,34 @@ void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
     return ptr;
 }
 
+// noinline: __builtin_return_address(0) must be the real call site
+__attribute__((noinline))
+void* tracked_malloc(size_t size, uint32_t caps, const char* description) {
+    return tracked_malloc_at(size, caps, description,
+                             caller_address(__builtin_return_address(0)), false);
+}
+
 void tracked_free(void* ptr, const char* description) {
     if (!ptr) return;
     
+    heap_sample_forget(ptr);
+    heap_frag_note(ptr, heap_caps_get_allocated_size(ptr), false);
+    
     if (memory_monitoring_enabled && memory_mutex) {
         if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
             int slot = find_allocation_by_ptr(ptr);
             if (slot >= 0) {
+                alloc_index_remove(ptr);
+                leak_note_free(slot);
                 allocations[slot].is_active = false;
+                release_allocation_slot(slot);
                 stats.total_deallocations++;
                 stats.current_allocations--;
                 stats.total_bytes_deallocated += allocations[slot].size;
                 
-                ESP_LOGI(TAG, "🗑️ Freed %d bytes at %p (%s) - Slot %d", 
-                         allocations[slot].size, ptr, description, slot);
+                alloc_log_post(ALLOC_EVENT_FREE, ptr, allocations[slot].size, slot, description);
             } else {
-                ESP_LOGW(TAG, "⚠️ Freeing untracked pointer %p (%s)", ptr, description);
+                alloc_log_post(ALLOC_EVENT_UNTRACKED_FREE, ptr, 0, -1, description);
             }
             
             xSemaphoreGive(memory_mutex);
@@ -142,6 +887,151 @@ void tracked_free(void* ptr, const char* description) {
     heap_caps_free(ptr);
 }
 
+// Placement policy: callers describe how the memory is used and the engine
+// picks the caps. Each hint has a preference order; the first pass only
+// takes a region whose live largest block fits the request (internal RAM
+// must also keep a FRAG_SHED_BLOCK_SIZE block free), the second pass tries
+// the same order unconditionally. DMA buffers never leave DMA memory.
+typedef enum {
+    ACCESS_HOT = 0,       // Touched in tight loops or from ISRs
+    ACCESS_WARM,          // Regular working data
+    ACCESS_COLD,          // Rarely touched: logs, history, assets
+    ACCESS_DMA,           // Handed to a peripheral
+    ACCESS_MAX
+} alloc_access_t;
+
+typedef enum {
+    LIFETIME_TRANSIENT = 0,   // Freed within the current operation
+    LIFETIME_SESSION,         // Lives for a connection or job
+    LIFETIME_PERMANENT        // Allocated once at startup
+} alloc_lifetime_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t bytes;
+} placement_counter_t;
+
+typedef struct {
+    placement_counter_t placed[ACCESS_MAX][FRAG_REGION_MAX];
+    uint32_t fallbacks;   // Not placed in the hint's first choice
+    uint32_t failures;
+} placement_stats_t;
+
+static placement_stats_t placement_stats = {0};
+static const char* access_names[ACCESS_MAX] = {"HOT", "WARM", "COLD", "DMA"};
+
+static const uint32_t placement_caps[FRAG_REGION_MAX] = {
+    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT,
+    MALLOC_CAP_DMA | MALLOC_CAP_8BIT
+};
+
+// Fills order[] with regions to try; returns how many
+static int placement_order(size_t size, alloc_access_t access, alloc_lifetime_t lifetime,
+                           frag_region_t order[FRAG_REGION_MAX]) {
+    bool internal_first;
+    
+    switch (access) {
+        case ACCESS_DMA:
+            order[0] = FRAG_REGION_DMA;
+            return 1;
+        case ACCESS_HOT:
+            internal_first = true;
+            break;
+        case ACCESS_COLD:
+            internal_first = false;
+            break;
+        default:
+            // Large long-lived buffers would pin internal RAM; short-lived ones give it back
+            internal_first = (size < PLACEMENT_LARGE_SIZE || lifetime == LIFETIME_TRANSIENT) &&
+                             heap_caps_get_free_size(MALLOC_CAP_INTERNAL) >= LOW_MEMORY_THRESHOLD;
+            break;
+    }
+    
+    order[0] = internal_first ? FRAG_REGION_INTERNAL : FRAG_REGION_SPIRAM;
+    order[1] = internal_first ? FRAG_REGION_SPIRAM : FRAG_REGION_INTERNAL;
+    return 2;
+}
+
+static void placement_record(void* ptr, size_t size, alloc_access_t access) {
+    frag_region_t region;
+    uint32_t mask = frag_regions_for_ptr(ptr);
+    
+    if (mask & (1u << FRAG_REGION_SPIRAM)) {
+        region = FRAG_REGION_SPIRAM;
+    } else if (access == ACCESS_DMA) {
+        region = FRAG_REGION_DMA;
+    } else {
+        region = FRAG_REGION_INTERNAL;
+    }
+    
+    placement_counter_t* counter = &placement_stats.placed[access][region];
+    __atomic_fetch_add(&counter->count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counter->bytes, size, __ATOMIC_RELAXED);
+}
+
+__attribute__((noinline))
+void* placed_malloc(size_t size, alloc_access_t access, alloc_lifetime_t lifetime, const char* description) {
+    uint32_t caller = caller_address(__builtin_return_address(0));
+    frag_region_t order[FRAG_REGION_MAX];
+    int candidates = placement_order(size, access, lifetime, order);
+    void* ptr = NULL;
+    int chosen = 0;
+    
+    // First pass: only regions the live snapshot says can take it comfortably
+    for (int i = 0; i < candidates && !ptr; i++) {
+        size_t reserve = (order[i] == FRAG_REGION_INTERNAL) ? FRAG_SHED_BLOCK_SIZE : 0;
+        if (heap_frag_can_allocate(order[i], size + reserve)) {
+            ptr = tracked_malloc_at(size, placement_caps[order[i]], description, caller, true);
+            chosen = i;
+        }
+    }
+    
+    // Second pass: same order, let the allocator decide. Only the last region's
+    // failure is counted, so one failed placement is one allocation failure
+    for (int i = 0; i < candidates && !ptr; i++) {
+        ptr = tracked_malloc_at(size, placement_caps[order[i]], description, caller,
+                                i < candidates - 1);
+        chosen = i;
+    }
+    
+    if (!ptr) {
+        __atomic_fetch_add(&placement_stats.failures, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    
+    if (chosen > 0) {
+        __atomic_fetch_add(&placement_stats.fallbacks, 1, __ATOMIC_RELAXED);
+    }
+    placement_record(ptr, size, access);
+    return ptr;
+}
+
+void print_placement_stats(void) {
+    ESP_LOGI(TAG, "\n🧭 ═══ PLACEMENT POLICY ═══");
+    
+    for (int a = 0; a < ACCESS_MAX; a++) {
+        placement_counter_t* p = placement_stats.placed[a];
+        uint64_t total = p[FRAG_REGION_INTERNAL].bytes + p[FRAG_REGION_SPIRAM].bytes +
+                         p[FRAG_REGION_DMA].bytes;
+        if (total == 0) continue;
+        
+        ESP_LOGI(TAG, "%-4s: INTERNAL %lu (%llu B), SPIRAM %lu (%llu B), DMA %lu (%llu B)",
+                 access_names[a],
+                 p[FRAG_REGION_INTERNAL].count, p[FRAG_REGION_INTERNAL].bytes,
+                 p[FRAG_REGION_SPIRAM].count, p[FRAG_REGION_SPIRAM].bytes,
+                 p[FRAG_REGION_DMA].count, p[FRAG_REGION_DMA].bytes);
+    }
+    
+    placement_counter_t* hot_slow = &placement_stats.placed[ACCESS_HOT][FRAG_REGION_SPIRAM];
+    uint64_t hot_total = placement_stats.placed[ACCESS_HOT][FRAG_REGION_INTERNAL].bytes + hot_slow->bytes;
+    if (hot_slow->count > 0) {
+        ESP_LOGW(TAG, "⚠️ Hot data in SPIRAM: %llu bytes (%.1f%% of hot)", hot_slow->bytes,
+                 100.0f * hot_slow->bytes / hot_total);
+    }
+    ESP_LOGI(TAG, "Fallbacks: %lu, Failures: %lu", placement_stats.fallbacks, placement_stats.failures);
+}
+
 // Memory analysis functions
 void analyze_memory_status(void) {
     size_t internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
@@ -215,55 +1105,42 @@ void print_allocation_summary(void) {
         ESP_LOGI(TAG, "Low Memory Events:    %lu", stats.low_memory_events);
         
         if (stats.current_allocations > 0) {
+            int listed = 0;
             ESP_LOGI(TAG, "\n🔍 ═══ ACTIVE ALLOCATIONS ═══");
-            for (int i = 0; i < MAX_ALLOCATIONS; i++) {
+            for (int i = 0; i < MAX_ALLOCATIONS && listed < SUMMARY_MAX_LISTED; i++) {
                 if (allocations[i].is_active) {
                     uint64_t age_ms = (esp_timer_get_time() - allocations[i].timestamp) / 1000;
                     ESP_LOGI(TAG, "Slot %d: %d bytes at %p (%s) - Age: %llu ms",
                              i, allocations[i].size, allocations[i].ptr,
                              allocations[i].description, age_ms);
+                    listed++;
                 }
             }
+            if (stats.current_allocations > listed) {
+                ESP_LOGI(TAG, "... and %lu more", stats.current_allocations - listed);
+            }
         }
         
         xSemaphoreGive(memory_mutex);
     }
 }
 
+// Monitor-driven checkpoint; cost follows the number of sites that changed
 void detect_memory_leaks(void) {
-    if (!memory_mutex) return;
+    ESP_LOGI(TAG, "\n🔍 ═══ MEMORY LEAK DETECTION ═══");
     
-    if (xSemaphoreTake(memory_mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
-        uint64_t current_time = esp_timer_get_time();
-        int leak_count = 0;
-        size_t leaked_bytes = 0;
-        
-        ESP_LOGI(TAG, "\n🔍 ═══ MEMORY LEAK DETECTION ═══");
-        
-        for (int i = 0; i < MAX_ALLOCATIONS; i++) {
-            if (allocations[i].is_active) {
-                uint64_t age_ms = (current_time - allocations[i].timestamp) / 1000;
-                
-                // Consider allocations older than 30 seconds as potential leaks
-                if (age_ms > 30000) {
-                    ESP_LOGW(TAG, "POTENTIAL LEAK: %d bytes at %p (%s) - Age: %llu ms",
-                             allocations[i].size, allocations[i].ptr,
-                             allocations[i].description, age_ms);
-                    leak_count++;
-                    leaked_bytes += allocations[i].size;
-                }
-            }
-        }
-        
-        if (leak_count > 0) {
-            ESP_LOGW(TAG, "Found %d potential leaks totaling %d bytes", leak_count, leaked_bytes);
-            gpio_set_level(LED_MEMORY_ERROR, 1);
-        } else {
-            ESP_LOGI(TAG, "No memory leaks detected");
-            gpio_set_level(LED_MEMORY_ERROR, 0);
-        }
-        
-        xSemaphoreGive(memory_mutex);
+    int growing = leak_epoch_checkpoint();
+    
+    if (growing > 0) {
+        ESP_LOGW(TAG, "Found %d call sites growing for %d+ epochs", growing, LEAK_GROWTH_EPOCHS);
+        gpio_set_level(LED_MEMORY_ERROR, 1);
+    } else {
+        ESP_LOGI(TAG, "No memory leaks detected");
+        gpio_set_level(LED_MEMORY_ERROR, 0);
+    }
+    
+    if (leak_untracked_allocs > 0) {
+        ESP_LOGW(TAG, "%lu allocations not attributed (site table full)", leak_untracked_allocs);
     }
 }
 
@@ -281,9 +1158,16 @@ void memory_stress_test_task(void *pvParameters) {
         if (action == 0 && allocation_count < 20) {
             // Allocate memory
             size_t size = 100 + (esp_random() % 2000); // 100-2100 bytes
-            uint32_t caps = (esp_random() % 2) ? MALLOC_CAP_INTERNAL : MALLOC_CAP_DEFAULT;
+            alloc_access_t access = esp_random() % ACCESS_DMA; // hot, warm or cold
+            
+            // Keep a packet-sized block free for the network path
+            if (!heap_frag_can_allocate(FRAG_REGION_INTERNAL, size + FRAG_SHED_BLOCK_SIZE)) {
+                ESP_LOGW(TAG, "🧩 Stress test: shedding %d byte allocation", size);
+                vTaskDelay(pdMS_TO_TICKS(1000));
+                continue;
+            }
             
-            test_ptrs[allocation_count] = tracked_malloc(size, caps, "StressTest");
+            test_ptrs[allocation_count] = placed_malloc(size, access, LIFETIME_SESSION, "StressTest");
             if (test_ptrs[allocation_count]) {
                 // Write some data to test memory
                 memset(test_ptrs[allocation_count], 0xAA, size);
@@ -365,16 +1249,13 @@ void large_allocation_test_task(void *pvParameters) {
         
         ESP_LOGI(TAG, "🐘 Attempting large allocation: %d bytes", large_size);
         
-        // Try internal RAM first, then SPIRAM
-        void* large_ptr = tracked_malloc(large_size, MALLOC_CAP_INTERNAL, "LargeInternal");
-        
-        if (!large_ptr) {
-            ESP_LOGW(TAG, "🐘 Internal RAM failed, trying SPIRAM...");
-            large_ptr = tracked_malloc(large_size, MALLOC_CAP_SPIRAM, "LargeSPIRAM");
-        }
+        // Warm, short-lived: internal RAM if it can spare the block, else SPIRAM
+        void* large_ptr = placed_malloc(large_size, ACCESS_WARM, LIFETIME_TRANSIENT, "Large");
         
         if (large_ptr) {
-            ESP_LOGI(TAG, "🐘 Large allocation successful: %p", large_ptr);
+            bool external = frag_regions_for_ptr(large_ptr) & (1u << FRAG_REGION_SPIRAM);
+            ESP_LOGI(TAG, "🐘 Large allocation successful: %p (%s)", large_ptr,
+                     external ? "SPIRAM" : "internal");
             
             // Test memory access performance
             uint64_t start_time = esp_timer_get_time();
@@ -405,6 +1286,8 @@ void memory_monitor_task(void *pvParameters) {
         vTaskDelay(pdMS_TO_TICKS(10000)); // Check every 10 seconds
         
         analyze_memory_status();
+        print_fragmentation_histogram();
+        print_placement_stats();
         print_allocation_summary();
         detect_memory_leaks();
         
@@ -478,6 +1361,352 @@ void heap_integrity_test_task(void *pvParameters) {
     }
 }
 
+// Binary heap profile, little endian: one header, then one record per live
+// sample. A host tool sums `weight` per caller (symbolized with addr2line)
+// to get live heap by call site; weight = size / (1 - exp(-size / interval)),
+// the unbiased estimate of bytes one sample stands for.
+#define HEAP_PROFILE_MAGIC    0x46525048  // "HPRF"
+#define HEAP_PROFILE_VERSION  1
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t sample_interval;
+    uint32_t record_count;
+    uint32_t dropped;
+    uint64_t timestamp_us;
+} heap_profile_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t caller;
+    uint32_t size;
+    uint32_t weight;
+    uint8_t size_class;    // ceil(log2(size))
+    uint8_t reserved[3];
+} heap_profile_record_t;
+
+size_t heap_profile_dump(uint8_t* out, size_t capacity) {
+    if (capacity < sizeof(heap_profile_header_t)) return 0;
+    
+    heap_profile_header_t* header = (heap_profile_header_t*)out;
+    heap_profile_record_t* records = (heap_profile_record_t*)(out + sizeof(*header));
+    size_t max_records = (capacity - sizeof(*header)) / sizeof(heap_profile_record_t);
+    uint32_t count = 0;
+    
+    portENTER_CRITICAL(&heap_sampler.lock);
+    for (int b = 0; b < (1 << HEAP_SAMPLE_TABLE_BITS) && count < max_records; b++) {
+        if (heap_sampler.table[b].ptr) {
+            records[count].caller = heap_sampler.table[b].caller;
+            records[count].size = heap_sampler.table[b].size;
+            count++;
+        }
+    }
+    header->dropped = heap_sampler.dropped;
+    portEXIT_CRITICAL(&heap_sampler.lock);
+    
+    // Weights outside the critical section: expf is not free
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t size = records[i].size;
+        float p = 1.0f - expf(-(float)size / HEAP_SAMPLE_INTERVAL_BYTES);
+        records[i].weight = (uint32_t)(size / p);
+        records[i].size_class = (size <= 1) ? 0 : 32 - __builtin_clz(size - 1);
+        memset(records[i].reserved, 0, sizeof(records[i].reserved));
+    }
+    
+    header->magic = HEAP_PROFILE_MAGIC;
+    header->version = HEAP_PROFILE_VERSION;
+    header->record_size = sizeof(heap_profile_record_t);
+    header->sample_interval = HEAP_SAMPLE_INTERVAL_BYTES;
+    header->record_count = count;
+    header->timestamp_us = esp_timer_get_time();
+    
+    return sizeof(*header) + count * sizeof(heap_profile_record_t);
+}
+
+// Hex-dump the profile between markers so it can be cut from a serial log
+void heap_profile_emit(void) {
+    size_t capacity = sizeof(heap_profile_header_t) +
+                      HEAP_SAMPLE_MAX_LIVE * sizeof(heap_profile_record_t);
+    uint8_t* buf = heap_caps_malloc(capacity, MALLOC_CAP_DEFAULT);
+    if (!buf) {
+        ESP_LOGE(TAG, "No memory for heap profile dump");
+        return;
+    }
+    
+    size_t length = heap_profile_dump(buf, capacity);
+    char line[2 * HEAP_PROFILE_HEX_PER_LINE + 1];
+    
+    ESP_LOGI(TAG, "HEAP_PROFILE_BEGIN %d", length);
+    for (size_t off = 0; off < length; off += HEAP_PROFILE_HEX_PER_LINE) {
+        size_t n = (length - off < HEAP_PROFILE_HEX_PER_LINE) ? length - off : HEAP_PROFILE_HEX_PER_LINE;
+        for (size_t i = 0; i < n; i++) {
+            snprintf(&line[2 * i], 3, "%02x", buf[off + i]);
+        }
+        ESP_LOGI(TAG, "%s", line);
+    }
+    ESP_LOGI(TAG, "HEAP_PROFILE_END");
+    
+    heap_caps_free(buf);
+}
+
+void heap_profile_task(void *pvParameters) {
+    ESP_LOGI(TAG, "🧬 Heap profiler sampling 1 in ~%d bytes", HEAP_SAMPLE_INTERVAL_BYTES);
+    
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(HEAP_PROFILE_PERIOD_MS));
+        
+        ESP_LOGI(TAG, "🧬 Heap profile: %lu live samples, %lu taken, %lu dropped",
+                 heap_sampler.live, heap_sampler.samples, heap_sampler.dropped);
+        heap_profile_emit();
+    }
+}
+
+// Tracker overhead: the same sizes through raw heap_caps_malloc/free and
+// through tracked_malloc/free, with TRACKING_BENCH_ALLOCS live at once
+void run_tracking_overhead_benchmark(void) {
+    size_t* sizes = heap_caps_malloc(TRACKING_BENCH_ALLOCS * sizeof(size_t), MALLOC_CAP_DEFAULT);
+    void** ptrs = heap_caps_malloc(TRACKING_BENCH_ALLOCS * sizeof(void*), MALLOC_CAP_DEFAULT);
+    
+    if (!sizes || !ptrs) {
+        ESP_LOGE(TAG, "Tracker benchmark setup failed");
+        heap_caps_free(sizes);
+        heap_caps_free(ptrs);
+        return;
+    }
+    
+    for (int i = 0; i < TRACKING_BENCH_ALLOCS; i++) {
+        sizes[i] = 16 + esp_random() % 240;
+    }
+    
+    // Measure tracking, not the log task
+    bool logging = alloc_event_logging;
+    alloc_event_logging = false;
+    
+    uint64_t raw_time = 0;
+    uint64_t tracked_time = 0;
+    
+    for (int round = 0; round < TRACKING_BENCH_ROUNDS; round++) {
+        // Frees visit the live set in a scattered order (odd stride over a power of two)
+        uint64_t start = esp_timer_get_time();
+        for (int i = 0; i < TRACKING_BENCH_ALLOCS; i++) {
+            ptrs[i] = heap_caps_malloc(sizes[i], MALLOC_CAP_DEFAULT);
+        }
+        for (int i = 0; i < TRACKING_BENCH_ALLOCS; i++) {
+            heap_caps_free(ptrs[(i * 7) % TRACKING_BENCH_ALLOCS]);
+        }
+        raw_time += esp_timer_get_time() - start;
+        
+        start = esp_timer_get_time();
+        for (int i = 0; i < TRACKING_BENCH_ALLOCS; i++) {
+            ptrs[i] = tracked_malloc(sizes[i], MALLOC_CAP_DEFAULT, "Bench");
+        }
+        for (int i = 0; i < TRACKING_BENCH_ALLOCS; i++) {
+            tracked_free(ptrs[(i * 7) % TRACKING_BENCH_ALLOCS], "Bench");
+        }
+        tracked_time += esp_timer_get_time() - start;
+    }
+    
+    alloc_event_logging = logging;
+    
+    float ops = 2.0f * TRACKING_BENCH_ALLOCS * TRACKING_BENCH_ROUNDS;
+    ESP_LOGI(TAG, "\n⏱️ ═══ TRACKER OVERHEAD (%d live allocations) ═══", TRACKING_BENCH_ALLOCS);
+    ESP_LOGI(TAG, "Raw heap_caps:   %.3f μs/op", raw_time / ops);
+    ESP_LOGI(TAG, "Tracked:         %.3f μs/op", tracked_time / ops);
+    ESP_LOGI(TAG, "Overhead:        %.1f%% of raw", 
+             raw_time ? 100.0f * ((float)tracked_time - raw_time) / raw_time : 0.0f);
+    
+    heap_caps_free(sizes);
+    heap_caps_free(ptrs);
+}
+
+// Bump-pointer arena for request-scoped data. Chunks come from one caps
+// region through tracked_malloc; allocation is an align-and-bump, and
+// everything is released at once by arena_reset() or by restoring a marker.
+// Released chunks stay on a spare list, so a steady request loop stops
+// touching the heap after the first few requests.
+typedef struct arena_chunk {
+    struct arena_chunk* next;  // Older chunk (current list) or next spare
+    size_t capacity;
+    uint8_t data[];
+} arena_chunk_t;
+
+typedef struct {
+    arena_chunk_t* current;    // Newest chunk first
+    arena_chunk_t* spare;
+    uint8_t* cursor;
+    uint8_t* limit;
+    size_t chunk_size;
+    uint32_t caps;
+    const char* name;
+    uint32_t chunk_allocs;     // Chunks taken from the heap over the arena lifetime
+} memory_arena_t;
+
+// Position to roll back to; markers nest and must be restored LIFO
+typedef struct {
+    arena_chunk_t* chunk;
+    uint8_t* cursor;
+} arena_marker_t;
+
+memory_arena_t* arena_create(const char* name, uint32_t caps, size_t chunk_size) {
+    memory_arena_t* arena = tracked_malloc(sizeof(memory_arena_t), MALLOC_CAP_INTERNAL, "ArenaStruct");
+    if (arena) {
+        memset(arena, 0, sizeof(memory_arena_t));
+        arena->name = name;
+        arena->caps = caps;
+        arena->chunk_size = chunk_size ? chunk_size : ARENA_CHUNK_SIZE;
+    }
+    return arena;
+}
+
+static bool arena_grow(memory_arena_t* arena, size_t needed) {
+    arena_chunk_t* chunk = NULL;
+    
+    // First spare that fits
+    for (arena_chunk_t** link = &arena->spare; *link; link = &(*link)->next) {
+        if ((*link)->capacity >= needed) {
+            chunk = *link;
+            *link = chunk->next;
+            break;
+        }
+    }
+    
+    if (!chunk) {
+        size_t capacity = (needed > arena->chunk_size) ? needed : arena->chunk_size;
+        chunk = tracked_malloc(sizeof(arena_chunk_t) + capacity, arena->caps, arena->name);
+        if (!chunk) {
+            return false;
+        }
+        chunk->capacity = capacity;
+        arena->chunk_allocs++;
+    }
+    
+    chunk->next = arena->current;
+    arena->current = chunk;
+    arena->cursor = chunk->data;
+    arena->limit = chunk->data + chunk->capacity;
+    return true;
+}
+
+// align must be a power of two
+void* arena_alloc_aligned(memory_arena_t* arena, size_t size, size_t align) {
+    uintptr_t p = ((uintptr_t)arena->cursor + align - 1) & ~(uintptr_t)(align - 1);
+    
+    if (!arena->cursor || p + size > (uintptr_t)arena->limit) {
+        if (!arena_grow(arena, size + align - 1)) {
+            return NULL;
+        }
+        p = ((uintptr_t)arena->cursor + align - 1) & ~(uintptr_t)(align - 1);
+    }
+    
+    arena->cursor = (uint8_t*)(p + size);
+    return (void*)p;
+}
+
+static inline void* arena_alloc(memory_arena_t* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, ARENA_DEFAULT_ALIGN);
+}
+
+static inline arena_marker_t arena_save(const memory_arena_t* arena) {
+    arena_marker_t marker = {arena->current, arena->cursor};
+    return marker;
+}
+
+void arena_restore(memory_arena_t* arena, arena_marker_t marker) {
+    // Chunks opened after the marker go back to the spare list
+    while (arena->current != marker.chunk) {
+        arena_chunk_t* chunk = arena->current;
+        arena->current = chunk->next;
+        chunk->next = arena->spare;
+        arena->spare = chunk;
+    }
+    
+    arena->cursor = marker.cursor;
+    arena->limit = marker.chunk ? marker.chunk->data + marker.chunk->capacity : NULL;
+}
+
+static inline void arena_reset(memory_arena_t* arena) {
+    arena_marker_t empty = {NULL, NULL};
+    arena_restore(arena, empty);
+}
+
+void arena_destroy(memory_arena_t* arena) {
+    if (!arena) return;
+    
+    arena_reset(arena);
+    while (arena->spare) {
+        arena_chunk_t* chunk = arena->spare;
+        arena->spare = chunk->next;
+        tracked_free(chunk, arena->name);
+    }
+    
+    tracked_free(arena, "ArenaStruct");
+}
+
+// Per-message processing: a header, a nested parse stage that is rolled
+// back, then the reply; malloc/free per object versus one arena per message
+void run_arena_benchmark(void) {
+    memory_arena_t* arena = arena_create("MsgArena", MALLOC_CAP_INTERNAL, ARENA_CHUNK_SIZE);
+    void** ptrs = heap_caps_malloc(ARENA_BENCH_ALLOCS * sizeof(void*), MALLOC_CAP_DEFAULT);
+    size_t sizes[ARENA_BENCH_ALLOCS];
+    
+    if (!arena || !ptrs) {
+        ESP_LOGE(TAG, "Arena benchmark setup failed");
+        arena_destroy(arena);
+        heap_caps_free(ptrs);
+        return;
+    }
+    
+    for (int i = 0; i < ARENA_BENCH_ALLOCS; i++) {
+        sizes[i] = 16 + esp_random() % 80;
+    }
+    
+    bool logging = alloc_event_logging;
+    alloc_event_logging = false;
+    
+    uint64_t start = esp_timer_get_time();
+    for (int m = 0; m < ARENA_BENCH_MESSAGES; m++) {
+        for (int i = 0; i < ARENA_BENCH_ALLOCS; i++) {
+            ptrs[i] = tracked_malloc(sizes[i], MALLOC_CAP_INTERNAL, "Msg");
+        }
+        for (int i = ARENA_BENCH_ALLOCS - 1; i >= 0; i--) {
+            tracked_free(ptrs[i], "Msg");
+        }
+    }
+    uint64_t malloc_time = esp_timer_get_time() - start;
+    
+    start = esp_timer_get_time();
+    for (int m = 0; m < ARENA_BENCH_MESSAGES; m++) {
+        int i = 0;
+        for (; i < ARENA_BENCH_ALLOCS / 4; i++) {
+            ptrs[i] = arena_alloc(arena, sizes[i]);
+        }
+        
+        arena_marker_t parse = arena_save(arena);
+        for (; i < ARENA_BENCH_ALLOCS / 2; i++) {
+            ptrs[i] = arena_alloc(arena, sizes[i]);
+        }
+        arena_restore(arena, parse);
+        
+        for (; i < ARENA_BENCH_ALLOCS; i++) {
+            ptrs[i] = arena_alloc(arena, sizes[i]);
+        }
+        arena_reset(arena);
+    }
+    uint64_t arena_time = esp_timer_get_time() - start;
+    
+    alloc_event_logging = logging;
+    
+    ESP_LOGI(TAG, "\n🧱 ═══ ARENA vs MALLOC (%d messages x %d objects) ═══",
+             ARENA_BENCH_MESSAGES, ARENA_BENCH_ALLOCS);
+    ESP_LOGI(TAG, "tracked_malloc/free: %.2f μs/message", (float)malloc_time / ARENA_BENCH_MESSAGES);
+    ESP_LOGI(TAG, "Arena:               %.2f μs/message (%lu chunk allocations)",
+             (float)arena_time / ARENA_BENCH_MESSAGES, arena->chunk_allocs);
+    
+    arena_destroy(arena);
+    heap_caps_free(ptrs);
+}
+
 void app_main(void) {
     ESP_LOGI(TAG, "🚀 Heap Management Lab Starting...");
     
@@ -503,10 +1732,18 @@ void app_main(void) {
     }
     
     // Initialize allocation tracking
-    memset(allocations, 0, sizeof(allocations));
+    init_allocation_tracking();
+    for (int r = 0; r < FRAG_REGION_MAX; r++) {
+        heap_frag_rebuild(r);
+    }
+    xTaskCreate(allocation_log_task, "AllocLog", 3072, NULL,
+                ALLOC_LOG_TASK_PRIORITY, &alloc_log.task);
     
     ESP_LOGI(TAG, "Memory tracking system initialized");
     
+    run_tracking_overhead_benchmark();
+    run_arena_benchmark();
+    
     // Initial memory analysis
     analyze_memory_status();
     
@@ -523,10 +1760,12 @@ void app_main(void) {
     ESP_LOGI(TAG, "Creating memory test tasks...");
     
     xTaskCreate(memory_monitor_task, "MemMonitor", 4096, NULL, 6, NULL);
+    xTaskCreate(heap_frag_monitor_task, "FragMonitor", 2048, NULL, 6, NULL);
     xTaskCreate(memory_stress_test_task, "StressTest", 3072, NULL, 5, NULL);
     xTaskCreate(memory_pool_test_task, "PoolTest", 3072, NULL, 5, NULL);
     xTaskCreate(large_allocation_test_task, "LargeAlloc", 2048, NULL, 4, NULL);
     xTaskCreate(heap_integrity_test_task, "IntegrityTest", 3072, NULL, 3, NULL);
+    xTaskCreate(heap_profile_task, "HeapProfile", 3072, NULL, 2, NULL);
     
     ESP_LOGI(TAG, "All tasks created successfully");
     
@@ -538,10 +1777,14 @@ void app_main(void) {
     ESP_LOGI(TAG, "  GPIO19 - SPIRAM Active (Blue)");
     
     ESP_LOGI(TAG, "\n🔬 Test Features:");
-    ESP_LOGI(TAG, "  • Dynamic Memory Allocation Tracking");
+    ESP_LOGI(TAG, "  • Dynamic Memory Allocation Tracking (hash-indexed)");
+    ESP_LOGI(TAG, "  • Deferred Allocation Logging");
+    ESP_LOGI(TAG, "  • Request-scoped Bump Arenas");
+    ESP_LOGI(TAG, "  • Hint-based Placement Policy (hot/warm/cold/DMA)");
+    ESP_LOGI(TAG, "  • Sampling Heap Profiler (binary dump by call site)");
     ESP_LOGI(TAG, "  • Real-time Memory Status Monitoring");
-    ESP_LOGI(TAG, "  • Memory Leak Detection");
-    ESP_LOGI(TAG, "  • Fragmentation Analysis");
+    ESP_LOGI(TAG, "  • Memory Leak Detection (per call site, by epoch)");
+    ESP_LOGI(TAG, "  • Fragmentation Analysis (per-region free block histogram)");
     ESP_LOGI(TAG, "  • Heap Integrity Checking");
     ESP_LOGI(TAG, "  • Memory Performance Testing");
     
@@ -589,51 +1832,6 @@ void analyze_allocation_patterns(void) {
 }
 
 
-// Batch allocation for related data
-typedef struct {
-    void* ptrs[10];
-    size_t sizes[10];
-    int count;
-    const char* batch_name;
-} memory_batch_t;
-
-memory_batch_t* create_memory_batch(const char* name) {
-    memory_batch_t* batch = tracked_malloc(sizeof(memory_batch_t), 
-                                          MALLOC_CAP_INTERNAL, "BatchStruct");
-    if (batch) {
-        memset(batch, 0, sizeof(memory_batch_t));
-        batch->batch_name = name;
-    }
-    return batch;
-}
-
-bool batch_allocate(memory_batch_t* batch, size_t size, uint32_t caps) {
-    if (!batch || batch->count >= 10) return false;
-    
-    batch->ptrs[batch->count] = tracked_malloc(size, caps, batch->batch_name);
-    if (batch->ptrs[batch->count]) {
-        batch->sizes[batch->count] = size;
-        batch->count++;
-        return true;
-    }
-    
-    return false;
-}
-
-void batch_free(memory_batch_t* batch) {
-    if (!batch) return;
-    
-    for (int i = 0; i < batch->count; i++) {
-        if (batch->ptrs[i]) {
-            tracked_free(batch->ptrs[i], batch->batch_name);
-            batch->ptrs[i] = NULL;
-        }
-    }
-    
-    tracked_free(batch, "BatchStruct");
-}
-
-
 // Safe allocation patterns
 #define SAFE_MALLOC(size, caps, desc) ({ \
     void* ptr = tracked_malloc(size, caps, desc); \
@@ -660,5 +1858,6 @@ void memory_usage_guidelines(void) {
     ESP_LOGI(TAG, "• Free memory in reverse allocation order when possible");
     ESP_LOGI(TAG, "• Monitor fragmentation regularly");
     ESP_LOGI(TAG, "• Use static allocation for critical systems");
+    ESP_LOGI(TAG, "• Use an arena for short-lived per-request objects");
     ESP_LOGI(TAG, "• Implement proper error handling");
 }
\ No newline at end of file
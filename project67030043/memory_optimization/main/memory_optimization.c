@@ -11,8 +11,12 @@
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_attr.h"
-#include "driver/gpio.h"
+
+#include "gpio_compat.h"
+#ifndef CONFIG_IDF_TARGET_LINUX
 #include "soc/soc_memory_layout.h"
+#include "esp_freertos_hooks.h"
+#endif
 
 static const char *TAG = "MEM_OPT";
 
@@ -31,18 +35,120 @@ static const char *TAG = "MEM_OPT";
 // Static memory pools for optimization demonstration
 #define STATIC_BUFFER_SIZE   4096
 #define STATIC_BUFFER_COUNT  8
+#define STATIC_BUFFER_WORDS  ((STATIC_BUFFER_COUNT + 31) / 32)
 #define TASK_STACK_SIZE      2048
-#define MAX_TASKS            4
+
+// Task slab: stack+TCB pairs per stack class, recycled when their task is deleted
+#define TASK_SLAB_CLASS_COUNT   3
+#define TASK_SLAB_SMALL_DEPTH   2048
+#define TASK_SLAB_MEDIUM_DEPTH  3072
+#define TASK_SLAB_LARGE_DEPTH   4096
+#define TASK_SLAB_SMALL_COUNT   4
+#define TASK_SLAB_MEDIUM_COUNT  2
+#define TASK_SLAB_LARGE_COUNT   1
+#define TASK_SLAB_SLOTS         (TASK_SLAB_SMALL_COUNT + TASK_SLAB_MEDIUM_COUNT + TASK_SLAB_LARGE_COUNT)
+#define TASK_SLAB_DEPTH_TOTAL   (TASK_SLAB_SMALL_DEPTH * TASK_SLAB_SMALL_COUNT + \
+                                 TASK_SLAB_MEDIUM_DEPTH * TASK_SLAB_MEDIUM_COUNT + \
+                                 TASK_SLAB_LARGE_DEPTH * TASK_SLAB_LARGE_COUNT)
+#define TASK_SLAB_TLS_INDEX     0      // TLS slot holding the owning task_slot_t
+#define TASK_SLAB_STACK_FILL    0xa5   // tskSTACK_FILL_BYTE, written over every new stack
+#define TASK_SLAB_WORKER_BURST  3      // short-lived workers per burst
+#define TASK_SLAB_IDLE_PASSES   2      // idle loops per core before an exited slot is reused
+
+// Activity LEDs are pulsed by a background task, never on the allocation path
+#define ACTIVITY_PULSE_MS       50
+#define ACTIVITY_TASK_PRIORITY  1
+
+// Template pools: power-of-two size classes from 16 to 2048 bytes,
+// X(block size, block count) in class order
+#define TEMPLATE_CLASSES(X) \
+    X(16, 64) X(32, 32) X(64, 16) X(128, 16) \
+    X(256, 8) X(512, 8) X(1024, 4) X(2048, 2)
+#define TEMPLATE_CLASS_ONE(size, count)     + 1
+#define TEMPLATE_CLASS_BYTES(size, count)   + (size) * (count)
+#define TEMPLATE_CLASS_SIZE(size, count)    size,
+#define TEMPLATE_CLASS_BLOCKS(size, count)  count,
+#define TEMPLATE_CLASS_COUNT    (0 TEMPLATE_CLASSES(TEMPLATE_CLASS_ONE))
+#define TEMPLATE_STORAGE_BYTES  (0 TEMPLATE_CLASSES(TEMPLATE_CLASS_BYTES))
+#define TEMPLATE_MIN_SHIFT      4
+
+// Memory budgets: bytes each subsystem may hold through the pool APIs
+#define BUDGET_SYSTEM_QUOTA     (16 * 1024)
+#define BUDGET_NETWORK_QUOTA    (24 * 1024)
+#define BUDGET_NETWORK_RESERVE  (4 * 1024)    // only emergency requests may use it
+#define BUDGET_SENSOR_QUOTA     (4 * 1024)
+#define BUDGET_LOGGING_QUOTA    (8 * 1024)
+#define BUDGET_NOISY_HELD       16            // buffers the noisy logger keeps
+
+// Access microbenchmarks
+#define BENCH_WARMUP_TRIALS     3
+#define BENCH_TRIALS            31         // odd, so the median is a real sample
+#define BENCH_T_95              2.042f     // Student t, 30 degrees of freedom
+#define BENCH_ACCESSES          65536      // dependent loads per trial
+#define BENCH_NODE_STRIDE       32         // bytes between chase nodes (one cache line)
+#define BENCH_MIN_WS_BYTES      1024
+#define BENCH_MAX_WS_BYTES      (512 * 1024)
+
+// Aligned pools: cache-line multiples carved from line-aligned slabs
+#define ALIGNED_POOL_LINE       64     // covers 32- and 64-byte cache lines and DMA
+#define ALIGNED_CLASS_COUNT     7      // 64 .. 4096 bytes
+#define ALIGNED_MIN_SHIFT       6
+#define ALIGNED_SLAB_BYTES      8192
+#define ALIGNED_MAX_SLABS       16     // per pool set
+#define ALIGNED_SLAB_WORDS      (ALIGNED_SLAB_BYTES / ALIGNED_POOL_LINE / 32)
 
 // Static allocations
 static uint8_t static_buffers[STATIC_BUFFER_COUNT][STATIC_BUFFER_SIZE] __attribute__((aligned(4)));
-static bool static_buffer_used[STATIC_BUFFER_COUNT] = {false};
-static SemaphoreHandle_t static_buffer_mutex;
+static uint32_t static_buffer_free[STATIC_BUFFER_WORDS];   // Bit set = buffer free
+static uint32_t static_buffers_in_use = 0;
 
-// Static task stacks
-static StackType_t task_stacks[MAX_TASKS][TASK_STACK_SIZE] __attribute__((aligned(8)));
-static StaticTask_t task_buffers[MAX_TASKS];
-static int next_task_slot = 0;
+// Static task stacks, carved into slab slots by task_slab_init()
+static StackType_t task_slab_storage[TASK_SLAB_DEPTH_TOTAL] __attribute__((aligned(8)));
+
+typedef enum {
+    TASK_SLOT_FREE = 0,
+    TASK_SLOT_RUNNING,
+    TASK_SLOT_EXITED,     // Task finished or deleted, may still be on the termination list
+    TASK_SLOT_RECLAIMING, // Off every list, waiting for the idle tasks to finish the TCB
+} task_slot_state_t;
+
+typedef struct {
+    StaticTask_t tcb;
+    StackType_t* stack;
+    TaskFunction_t entry;
+    void* arg;
+    uint8_t cls;
+    uint8_t state;
+    int8_t next_free;     // Next slot of the same class, -1 ends the list
+    uint32_t idle_mark[portNUM_PROCESSORS];   // Idle passes when reclaiming began
+} task_slot_t;
+
+typedef struct {
+    uint32_t stack_depth;    // In StackType_t units, as xTaskCreateStatic takes it
+    uint8_t count;
+    int8_t free_head;
+    uint8_t in_use;
+    uint8_t peak_in_use;
+    uint32_t min_headroom;   // Least untouched stack (bytes) any finished task left
+    uint32_t created;
+    uint32_t exhausted;      // Requests that found the class and all larger ones full
+} task_slab_class_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    task_slot_t slots[TASK_SLAB_SLOTS];
+    task_slab_class_t classes[TASK_SLAB_CLASS_COUNT];
+    uint32_t idle_passes[portNUM_PROCESSORS];   // Idle loop iterations per core
+} task_slab_t;
+
+static task_slab_t task_slab = {
+    .lock = portMUX_INITIALIZER_UNLOCKED,
+    .classes = {
+        {.stack_depth = TASK_SLAB_SMALL_DEPTH,  .count = TASK_SLAB_SMALL_COUNT},
+        {.stack_depth = TASK_SLAB_MEDIUM_DEPTH, .count = TASK_SLAB_MEDIUM_COUNT},
+        {.stack_depth = TASK_SLAB_LARGE_DEPTH,  .count = TASK_SLAB_LARGE_COUNT},
+    },
+};
 
 // Memory optimization statistics
 typedef struct {
@@ -87,53 +193,92 @@ typedef struct {
     bool is_dma_capable;
 } memory_region_info_t;
 
-// Static buffer management
-void* allocate_static_buffer(void) {
-    void* buffer = NULL;
+// Activity indicator: allocators set the LED's bit in the indicator task's
+// notification value; the task lights every LED set, holds one pulse, clears.
+// Repeated pulses of the same LED coalesce, so nothing is queued or dropped
+static TaskHandle_t activity_task = NULL;
+static uint32_t activity_posted = 0;
+
+static void activity_post(gpio_num_t led) {
+    __atomic_fetch_add(&activity_posted, 1, __ATOMIC_RELAXED);
+    if (activity_task) {
+        xTaskNotify(activity_task, 1UL << led, eSetBits);
+    }
+}
+
+void activity_indicator_task(void *pvParameters) {
+    uint32_t lit;
     
-    if (static_buffer_mutex && xSemaphoreTake(static_buffer_mutex, pdMS_TO_TICKS(100))) {
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
-            if (!static_buffer_used[i]) {
-                static_buffer_used[i] = true;
-                buffer = static_buffers[i];
+    while (1) {
+        xTaskNotifyWait(0, UINT32_MAX, &lit, portMAX_DELAY);
+        
+        for (int pin = 0; pin < 32; pin++) {
+            if (lit & (1UL << pin)) gpio_set_level((gpio_num_t)pin, 1);
+        }
+        vTaskDelay(pdMS_TO_TICKS(ACTIVITY_PULSE_MS));
+        for (int pin = 0; pin < 32; pin++) {
+            if (lit & (1UL << pin)) gpio_set_level((gpio_num_t)pin, 0);
+        }
+    }
+}
+
+// Static buffer management: lock-free bitmask. Acquire claims the lowest
+// set bit of a word with CAS, release sets the bit found by pointer
+// arithmetic; the in-use count drives the LED on its 0 <-> 1 transitions.
+void static_buffers_init(void) {
+    for (int w = 0; w < STATIC_BUFFER_WORDS; w++) {
+        int bits = STATIC_BUFFER_COUNT - w * 32;
+        static_buffer_free[w] = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1);
+    }
+    __atomic_store_n(&static_buffers_in_use, 0, __ATOMIC_RELEASE);
+}
+
+void* allocate_static_buffer(void) {
+    for (int w = 0; w < STATIC_BUFFER_WORDS; w++) {
+        uint32_t word = __atomic_load_n(&static_buffer_free[w], __ATOMIC_RELAXED);
+        
+        while (word) {
+            int bit = __builtin_ctz(word);
+            // On failure word is reloaded and the next free bit is tried
+            if (__atomic_compare_exchange_n(&static_buffer_free[w], &word, word & ~(1u << bit),
+                                            true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                int index = w * 32 + bit;
+                
+                if (__atomic_fetch_add(&static_buffers_in_use, 1, __ATOMIC_RELAXED) == 0) {
+                    gpio_set_level(LED_STATIC_ALLOC, 1);
+                }
                 opt_stats.static_allocations++;
-                ESP_LOGD(TAG, "🟢 Static buffer %d allocated: %p", i, buffer);
-                gpio_set_level(LED_STATIC_ALLOC, 1);
-                break;
+                ESP_LOGD(TAG, "🟢 Static buffer %d allocated: %p", index, static_buffers[index]);
+                return static_buffers[index];
             }
         }
-        xSemaphoreGive(static_buffer_mutex);
     }
     
-    return buffer;
+    return NULL;
 }
 
 void free_static_buffer(void* buffer) {
-    if (!buffer || !static_buffer_mutex) return;
+    if (!buffer) return;
     
-    if (xSemaphoreTake(static_buffer_mutex, pdMS_TO_TICKS(100))) {
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
-            if (buffer == static_buffers[i] && static_buffer_used[i]) {
-                static_buffer_used[i] = false;
-                ESP_LOGD(TAG, "🗑️ Static buffer %d freed: %p", i, buffer);
-                break;
-            }
-        }
-        
-        // Check if any static buffers still in use
-        bool any_used = false;
-        for (int i = 0; i < STATIC_BUFFER_COUNT; i++) {
-            if (static_buffer_used[i]) {
-                any_used = true;
-                break;
-            }
-        }
-        
-        if (!any_used) {
-            gpio_set_level(LED_STATIC_ALLOC, 0);
-        }
-        
-        xSemaphoreGive(static_buffer_mutex);
+    uintptr_t offset = (uintptr_t)buffer - (uintptr_t)static_buffers;
+    if ((uint8_t*)buffer < &static_buffers[0][0] || offset % STATIC_BUFFER_SIZE != 0 ||
+        offset / STATIC_BUFFER_SIZE >= STATIC_BUFFER_COUNT) {
+        ESP_LOGE(TAG, "free_static_buffer: %p is not a static buffer", buffer);
+        return;
+    }
+    
+    int index = offset / STATIC_BUFFER_SIZE;
+    uint32_t mask = 1u << (index % 32);
+    uint32_t prev = __atomic_fetch_or(&static_buffer_free[index / 32], mask, __ATOMIC_RELEASE);
+    
+    if (prev & mask) {
+        ESP_LOGE(TAG, "free_static_buffer: buffer %d freed twice", index);
+        return;
+    }
+    
+    ESP_LOGD(TAG, "🗑️ Static buffer %d freed: %p", index, buffer);
+    if (__atomic_sub_fetch(&static_buffers_in_use, 1, __ATOMIC_RELAXED) == 0) {
+        gpio_set_level(LED_STATIC_ALLOC, 0);
     }
 }
 
@@ -167,9 +312,7 @@ void* aligned_malloc(size_t size, size_t alignment) {
     ESP_LOGD(TAG, "🎯 Aligned malloc: %d bytes, %d-byte aligned at %p", 
              size, alignment, aligned_ptr);
     
-    gpio_set_level(LED_ALIGNMENT_OPT, 1);
-    vTaskDelay(pdMS_TO_TICKS(50));
-    gpio_set_level(LED_ALIGNMENT_OPT, 0);
+    activity_post(LED_ALIGNMENT_OPT);
     
     return aligned_ptr;
 }
@@ -185,6 +328,443 @@ void aligned_free(void* aligned_ptr) {
     free(orig_ptr);
 }
 
+// Aligned size-class pools. Every class is a multiple of ALIGNED_POOL_LINE
+// and slabs are line-aligned, so every block is line-aligned with no header
+// and no per-allocation slack beyond class rounding; the owning slab is
+// found by address. Requests larger than a class or with a stricter
+// alignment go straight to heap_caps_aligned_alloc. Each slab keeps one
+// bit per block handed out, so interior pointers and double frees are
+// rejected instead of corrupting the free list.
+typedef struct {
+    uint8_t* base;
+    uint8_t cls;
+    uint32_t live[ALIGNED_SLAB_WORDS];   // Set while the block is allocated
+} aligned_slab_t;
+
+typedef struct {
+    const char* name;
+    uint32_t caps;
+    portMUX_TYPE lock;
+    void* free_lists[ALIGNED_CLASS_COUNT];
+    aligned_slab_t slabs[ALIGNED_MAX_SLABS];
+    int slab_count;            // Published with release after the slab entry
+    uint32_t pooled;
+    uint32_t direct;
+    uint32_t rejected;         // Misaligned, interior or double frees
+    uint64_t rounding_slack;   // Bytes lost to class rounding, cumulative
+} aligned_pool_set_t;
+
+static aligned_pool_set_t aligned_sets[2] = {
+    {.name = "default", .caps = MALLOC_CAP_8BIT, .lock = portMUX_INITIALIZER_UNLOCKED},
+    {.name = "DMA", .caps = MALLOC_CAP_DMA | MALLOC_CAP_8BIT, .lock = portMUX_INITIALIZER_UNLOCKED}
+};
+
+static bool aligned_pool_grow(aligned_pool_set_t* set, int cls) {
+    size_t block = (size_t)ALIGNED_POOL_LINE << cls;
+    uint8_t* slab = heap_caps_aligned_alloc(ALIGNED_POOL_LINE, ALIGNED_SLAB_BYTES, set->caps);
+    if (!slab) return false;
+    
+    portENTER_CRITICAL(&set->lock);
+    if (set->slab_count >= ALIGNED_MAX_SLABS) {
+        portEXIT_CRITICAL(&set->lock);
+        heap_caps_free(slab);
+        return false;
+    }
+    
+    set->slabs[set->slab_count].base = slab;
+    set->slabs[set->slab_count].cls = cls;
+    memset(set->slabs[set->slab_count].live, 0, sizeof(set->slabs[set->slab_count].live));
+    __atomic_store_n(&set->slab_count, set->slab_count + 1, __ATOMIC_RELEASE);
+    
+    for (size_t off = 0; off + block <= ALIGNED_SLAB_BYTES; off += block) {
+        *(void**)(slab + off) = set->free_lists[cls];
+        set->free_lists[cls] = slab + off;
+    }
+    portEXIT_CRITICAL(&set->lock);
+    
+    activity_post(LED_ALIGNMENT_OPT);
+    return true;
+}
+
+// Slab of set holding ptr, or NULL if ptr is not inside one of its slabs
+static aligned_slab_t* aligned_slab_for(aligned_pool_set_t* set, const void* ptr) {
+    int count = __atomic_load_n(&set->slab_count, __ATOMIC_ACQUIRE);
+    
+    for (int i = 0; i < count; i++) {
+        uint8_t* base = set->slabs[i].base;
+        if ((const uint8_t*)ptr >= base && (const uint8_t*)ptr < base + ALIGNED_SLAB_BYTES) {
+            return &set->slabs[i];
+        }
+    }
+    return NULL;
+}
+
+// First pool set whose slabs carry every requested capability, or NULL
+static aligned_pool_set_t* aligned_pool_set_for(uint32_t caps) {
+    for (int s = 0; s < 2; s++) {
+        if ((aligned_sets[s].caps & caps) == caps) {
+            return &aligned_sets[s];
+        }
+    }
+    return NULL;
+}
+
+// caps are honoured in full: MALLOC_CAP_DMA selects the DMA set, and caps
+// no set provides (SPIRAM, INTERNAL, ...) bypass the pools
+void* aligned_pool_malloc(size_t size, size_t alignment, uint32_t caps) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        ESP_LOGE(TAG, "Invalid alignment: %d (must be power of 2)", alignment);
+        return NULL;
+    }
+    
+    aligned_pool_set_t* set = aligned_pool_set_for(caps);
+    if (!set) {
+        void* ptr = heap_caps_aligned_alloc(alignment < 4 ? 4 : alignment, size, caps);
+        if (ptr) opt_stats.dynamic_allocations++;
+        return ptr;
+    }
+    
+    int cls = (size <= ALIGNED_POOL_LINE) ? 0 : 32 - __builtin_clz(size - 1) - ALIGNED_MIN_SHIFT;
+    opt_stats.alignment_optimizations++;
+    
+    if (cls < ALIGNED_CLASS_COUNT && alignment <= ALIGNED_POOL_LINE) {
+        for (int attempt = 0; attempt < 2; attempt++) {
+            portENTER_CRITICAL(&set->lock);
+            void** block = set->free_lists[cls];
+            if (block) {
+                aligned_slab_t* slab = aligned_slab_for(set, block);
+                uint32_t index = ((uint8_t*)block - slab->base) >> (cls + ALIGNED_MIN_SHIFT);
+                slab->live[index / 32] |= 1UL << (index % 32);
+                set->free_lists[cls] = *block;
+                set->pooled++;
+                set->rounding_slack += ((size_t)ALIGNED_POOL_LINE << cls) - size;
+            }
+            portEXIT_CRITICAL(&set->lock);
+            
+            if (block) return block;
+            if (!aligned_pool_grow(set, cls)) break;
+        }
+    }
+    
+    // Too big, too strictly aligned, or out of slabs
+    void* ptr = heap_caps_aligned_alloc(alignment < 4 ? 4 : alignment, size, set->caps);
+    if (ptr) {
+        portENTER_CRITICAL(&set->lock);
+        set->direct++;
+        portEXIT_CRITICAL(&set->lock);
+        opt_stats.dynamic_allocations++;
+    }
+    return ptr;
+}
+
+void aligned_pool_free(void* ptr) {
+    if (!ptr) return;
+    
+    aligned_pool_set_t* set = NULL;
+    aligned_slab_t* slab = NULL;
+    for (int s = 0; s < 2 && !slab; s++) {
+        set = &aligned_sets[s];
+        slab = aligned_slab_for(set, ptr);
+    }
+    if (!slab) {
+        heap_caps_free(ptr);
+        return;
+    }
+    
+    size_t offset = (uint8_t*)ptr - slab->base;
+    uint32_t shift = slab->cls + ALIGNED_MIN_SHIFT;
+    uint32_t index = offset >> shift;
+    uint32_t bit = 1UL << (index % 32);
+    bool misaligned = (offset & ((1UL << shift) - 1)) != 0;
+    bool was_live = false;
+    
+    portENTER_CRITICAL(&set->lock);
+    if (!misaligned) {
+        was_live = (slab->live[index / 32] & bit) != 0;
+    }
+    if (was_live) {
+        slab->live[index / 32] &= ~bit;
+        *(void**)ptr = set->free_lists[slab->cls];
+        set->free_lists[slab->cls] = ptr;
+    } else {
+        set->rejected++;
+    }
+    portEXIT_CRITICAL(&set->lock);
+    
+    if (!was_live) {
+        ESP_LOGE(TAG, "❌ Aligned free of %p rejected: %s (%s slab %p, %u-byte blocks)",
+                 ptr, misaligned ? "not a block start" : "block already free",
+                 set->name, slab->base, 1U << shift);
+    }
+}
+
+void print_aligned_pool_stats(void) {
+    for (int s = 0; s < 2; s++) {
+        aligned_pool_set_t* set = &aligned_sets[s];
+        ESP_LOGI(TAG, "Aligned pools (%s): %d slabs, %lu pooled, %lu direct, %lu rejected frees, "
+                 "%llu B rounding slack",
+                 set->name, set->slab_count, set->pooled, set->direct, set->rejected,
+                 set->rounding_slack);
+    }
+}
+
+// Template-based memory pools for common sizes. Segregated fit over one
+// static array: each class has an intrusive free list threaded through its
+// idle blocks, so alloc and free are a list pop/push. A class that runs dry
+// spills to malloc and the spill is counted per class.
+typedef struct {
+    size_t sizes[TEMPLATE_CLASS_COUNT];       // Common allocation sizes
+    void* pools[TEMPLATE_CLASS_COUNT];        // Free list head per class
+    int pool_counts[TEMPLATE_CLASS_COUNT];    // Number of blocks per pool
+    int usage_counts[TEMPLATE_CLASS_COUNT];   // Current usage
+    int peak_usage[TEMPLATE_CLASS_COUNT];
+    uint8_t* bases[TEMPLATE_CLASS_COUNT];     // First block of each class
+    uint32_t spills[TEMPLATE_CLASS_COUNT];    // Class empty, served by malloc
+    uint32_t oversize;                        // Larger than the biggest class
+    portMUX_TYPE lock;
+} template_pool_system_t;
+
+static uint8_t template_storage[TEMPLATE_STORAGE_BYTES] __attribute__((aligned(8)));
+
+template_pool_system_t template_pools = {
+    .sizes = { TEMPLATE_CLASSES(TEMPLATE_CLASS_SIZE) },
+    .pool_counts = { TEMPLATE_CLASSES(TEMPLATE_CLASS_BLOCKS) },
+    .lock = portMUX_INITIALIZER_UNLOCKED
+};
+
+void template_pools_init(void) {
+    uint8_t* cursor = template_storage;
+    
+    for (int c = 0; c < TEMPLATE_CLASS_COUNT; c++) {
+        template_pools.bases[c] = cursor;
+        template_pools.pools[c] = NULL;
+        
+        // Thread back to front so the list hands out blocks in address order
+        for (int i = template_pools.pool_counts[c] - 1; i >= 0; i--) {
+            void** block = (void**)(cursor + i * template_pools.sizes[c]);
+            *block = template_pools.pools[c];
+            template_pools.pools[c] = block;
+        }
+        
+        cursor += template_pools.pool_counts[c] * template_pools.sizes[c];
+    }
+    
+    ESP_LOGI(TAG, "Template pools: %d classes in %d bytes of static storage",
+             TEMPLATE_CLASS_COUNT, TEMPLATE_STORAGE_BYTES);
+}
+
+static inline int template_class(size_t size) {
+    if (size <= (1u << TEMPLATE_MIN_SHIFT)) return 0;
+    return 32 - __builtin_clz(size - 1) - TEMPLATE_MIN_SHIFT;
+}
+
+void* template_malloc(size_t size) {
+    int c = template_class(size);
+    
+    if (c >= TEMPLATE_CLASS_COUNT) {
+        portENTER_CRITICAL(&template_pools.lock);
+        template_pools.oversize++;
+        portEXIT_CRITICAL(&template_pools.lock);
+        opt_stats.dynamic_allocations++;
+        return malloc(size);
+    }
+    
+    portENTER_CRITICAL(&template_pools.lock);
+    void** block = template_pools.pools[c];
+    if (block) {
+        template_pools.pools[c] = *block;
+        template_pools.usage_counts[c]++;
+        if (template_pools.usage_counts[c] > template_pools.peak_usage[c]) {
+            template_pools.peak_usage[c] = template_pools.usage_counts[c];
+        }
+    } else {
+        template_pools.spills[c]++;
+    }
+    portEXIT_CRITICAL(&template_pools.lock);
+    
+    if (!block) {
+        opt_stats.dynamic_allocations++;
+        return malloc(size);
+    }
+    
+    opt_stats.static_allocations++;
+    return block;
+}
+
+void template_free(void* ptr) {
+    if (!ptr) return;
+    
+    uint8_t* p = (uint8_t*)ptr;
+    if (p < template_storage || p >= template_storage + TEMPLATE_STORAGE_BYTES) {
+        free(ptr);   // Spilled or oversize
+        return;
+    }
+    
+    // Classes are laid out in ascending order, so the last base at or below p owns it
+    int c = TEMPLATE_CLASS_COUNT - 1;
+    while (p < template_pools.bases[c]) {
+        c--;
+    }
+    
+    portENTER_CRITICAL(&template_pools.lock);
+    *(void**)ptr = template_pools.pools[c];
+    template_pools.pools[c] = ptr;
+    template_pools.usage_counts[c]--;
+    portEXIT_CRITICAL(&template_pools.lock);
+}
+
+void print_template_pool_stats(void) {
+    ESP_LOGI(TAG, "Template Pools (class: used/peak/total, spills):");
+    for (int c = 0; c < TEMPLATE_CLASS_COUNT; c++) {
+        ESP_LOGI(TAG, "  %4d B: %d/%d/%d, %lu spills", template_pools.sizes[c],
+                 template_pools.usage_counts[c], template_pools.peak_usage[c],
+                 template_pools.pool_counts[c], template_pools.spills[c]);
+    }
+    ESP_LOGI(TAG, "  Oversize (heap): %lu", template_pools.oversize);
+}
+
+// Memory budget tracking. Each subsystem has a quota, part of which can be
+// held back as an emergency reserve. Charges are a CAS on the subsystem's
+// byte count, so a noisy subsystem fails on its own quota instead of
+// draining memory the network stack needs. Before failing, the subsystem's
+// pressure callback may release memory and the charge is retried once.
+typedef enum {
+    BUDGET_SYSTEM = 0,
+    BUDGET_NETWORK,
+    BUDGET_SENSORS,
+    BUDGET_LOGGING,
+    BUDGET_SUBSYSTEM_COUNT
+} budget_subsystem_t;
+
+// Returns true if it released memory and the charge should be retried
+typedef bool (*budget_pressure_cb_t)(budget_subsystem_t id, size_t shortfall, void* arg);
+
+typedef struct {
+    const char* name;
+    size_t total_budget;         // Quota
+    size_t allocated;            // Charged bytes, updated atomically
+    size_t peak;                 // Peak charged bytes
+    size_t emergency_reserve;    // Top of the quota kept for emergency requests
+    uint32_t denials;
+    uint32_t pressure_calls;
+    budget_pressure_cb_t pressure_cb;
+    void* pressure_arg;
+} memory_budget_t;
+
+static memory_budget_t budgets[BUDGET_SUBSYSTEM_COUNT] = {
+    [BUDGET_SYSTEM]  = {.name = "system",  .total_budget = BUDGET_SYSTEM_QUOTA},
+    [BUDGET_NETWORK] = {.name = "network", .total_budget = BUDGET_NETWORK_QUOTA,
+                        .emergency_reserve = BUDGET_NETWORK_RESERVE},
+    [BUDGET_SENSORS] = {.name = "sensors", .total_budget = BUDGET_SENSOR_QUOTA},
+    [BUDGET_LOGGING] = {.name = "logging", .total_budget = BUDGET_LOGGING_QUOTA},
+};
+
+void budget_set_pressure_callback(budget_subsystem_t id, budget_pressure_cb_t cb, void* arg) {
+    budgets[id].pressure_arg = arg;
+    budgets[id].pressure_cb = cb;
+}
+
+bool budget_charge(budget_subsystem_t id, size_t bytes, bool emergency) {
+    memory_budget_t* budget = &budgets[id];
+    size_t limit = budget->total_budget - (emergency ? 0 : budget->emergency_reserve);
+    bool retried = false;
+    
+    size_t current = __atomic_load_n(&budget->allocated, __ATOMIC_RELAXED);
+    while (1) {
+        if (current + bytes > limit) {
+            if (!retried && budget->pressure_cb) {
+                retried = true;
+                __atomic_fetch_add(&budget->pressure_calls, 1, __ATOMIC_RELAXED);
+                if (budget->pressure_cb(id, current + bytes - limit, budget->pressure_arg)) {
+                    current = __atomic_load_n(&budget->allocated, __ATOMIC_RELAXED);
+                    continue;
+                }
+            }
+            __atomic_fetch_add(&budget->denials, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        if (__atomic_compare_exchange_n(&budget->allocated, &current, current + bytes,
+                                        true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    
+    // Peak is informational; a lost race here only under-reports it
+    if (current + bytes > budget->peak) {
+        budget->peak = current + bytes;
+    }
+    return true;
+}
+
+void budget_release(budget_subsystem_t id, size_t bytes) {
+    __atomic_fetch_sub(&budgets[id].allocated, bytes, __ATOMIC_RELAXED);
+}
+
+// What a template pool request really occupies: its class, or itself if oversize
+static inline size_t template_charge(size_t size) {
+    int c = template_class(size);
+    return (c < TEMPLATE_CLASS_COUNT) ? template_pools.sizes[c] : size;
+}
+
+static inline size_t aligned_charge(size_t size) {
+    int cls = (size <= ALIGNED_POOL_LINE) ? 0 : 32 - __builtin_clz(size - 1) - ALIGNED_MIN_SHIFT;
+    return (cls < ALIGNED_CLASS_COUNT) ? ((size_t)ALIGNED_POOL_LINE << cls) : size;
+}
+
+// Budgeted front ends for the pool APIs; frees take the same size back
+void* budget_malloc(budget_subsystem_t id, size_t size, bool emergency) {
+    if (!budget_charge(id, template_charge(size), emergency)) return NULL;
+    
+    void* ptr = template_malloc(size);
+    if (!ptr) budget_release(id, template_charge(size));
+    return ptr;
+}
+
+void budget_free(budget_subsystem_t id, void* ptr, size_t size) {
+    if (!ptr) return;
+    template_free(ptr);
+    budget_release(id, template_charge(size));
+}
+
+void* budget_aligned_malloc(budget_subsystem_t id, size_t size, size_t alignment, uint32_t caps) {
+    if (!budget_charge(id, aligned_charge(size), false)) return NULL;
+    
+    void* ptr = aligned_pool_malloc(size, alignment, caps);
+    if (!ptr) budget_release(id, aligned_charge(size));
+    return ptr;
+}
+
+void budget_aligned_free(budget_subsystem_t id, void* ptr, size_t size) {
+    if (!ptr) return;
+    aligned_pool_free(ptr);
+    budget_release(id, aligned_charge(size));
+}
+
+void* budget_static_buffer(budget_subsystem_t id) {
+    if (!budget_charge(id, STATIC_BUFFER_SIZE, false)) return NULL;
+    
+    void* buffer = allocate_static_buffer();
+    if (!buffer) budget_release(id, STATIC_BUFFER_SIZE);
+    return buffer;
+}
+
+void budget_free_static_buffer(budget_subsystem_t id, void* buffer) {
+    if (!buffer) return;
+    free_static_buffer(buffer);
+    budget_release(id, STATIC_BUFFER_SIZE);
+}
+
+void print_budget_stats(void) {
+    ESP_LOGI(TAG, "Memory Budgets (used/peak/quota, denials, pressure calls):");
+    for (int i = 0; i < BUDGET_SUBSYSTEM_COUNT; i++) {
+        memory_budget_t* b = &budgets[i];
+        float usage_percent = ((float)b->allocated / b->total_budget) * 100.0;
+        ESP_LOGI(TAG, "  %-8s %6d/%6d/%6d B (%.1f%%), %lu denied, %lu pressure",
+                 b->name, b->allocated, b->peak, b->total_budget, usage_percent,
+                 b->denials, b->pressure_calls);
+    }
+}
+
 // Struct packing optimization demonstration
 void demonstrate_struct_optimization(void) {
     ESP_LOGI(TAG, "\n🏗️ ═══ STRUCT OPTIMIZATION DEMO ═══");
@@ -276,94 +856,244 @@ void analyze_memory_regions(void) {
     ESP_LOGI(TAG, "═══════════════════════════════════════");
 }
 
-// Memory access pattern optimization
-void optimize_memory_access_patterns(void) {
-    ESP_LOGI(TAG, "\n⚡ ═══ MEMORY ACCESS OPTIMIZATION ═══");
+// Benchmark harness: warmup, BENCH_TRIALS timed trials, then median, p95,
+// mean and a 95% confidence interval of the mean. Random access walks a
+// precomputed single-cycle permutation stored in the buffer itself, so
+// the timed loop is one dependent load per access with no RNG in it.
+typedef struct {
+    float median;
+    float p95;
+    float mean;
+    float ci95;     // Half-width
+    float min;
+} bench_summary_t;
+
+typedef float (*bench_trial_fn)(void* ctx);   // One trial, ns per access
+
+static volatile uint32_t bench_sink;
+
+static void bench_summarize(float* samples, int n, bench_summary_t* out) {
+    // Insertion sort: n is small and this runs outside the timed region
+    for (int i = 1; i < n; i++) {
+        float v = samples[i];
+        int j = i - 1;
+        while (j >= 0 && samples[j] > v) {
+            samples[j + 1] = samples[j];
+            j--;
+        }
+        samples[j + 1] = v;
+    }
     
-    const size_t array_size = 1024;
-    const int iterations = 1000;
+    float sum = 0, sq = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    out->mean = sum / n;
+    for (int i = 0; i < n; i++) sq += (samples[i] - out->mean) * (samples[i] - out->mean);
     
-    // Test 1: Sequential vs Random access
-    uint32_t* test_array = aligned_malloc(array_size * sizeof(uint32_t), 32);
-    if (!test_array) {
-        ESP_LOGE(TAG, "Failed to allocate test array");
-        return;
+    out->median = samples[n / 2];
+    out->p95 = samples[(95 * n + 99) / 100 - 1];
+    out->min = samples[0];
+    out->ci95 = BENCH_T_95 * sqrtf(sq / (n - 1)) / sqrtf(n);
+}
+
+static void bench_run(bench_trial_fn trial, void* ctx, bench_summary_t* out) {
+    float samples[BENCH_TRIALS];
+    
+    for (int i = 0; i < BENCH_WARMUP_TRIALS; i++) {
+        trial(ctx);
+    }
+    for (int i = 0; i < BENCH_TRIALS; i++) {
+        samples[i] = trial(ctx);
     }
     
-    // Initialize array
-    for (size_t i = 0; i < array_size; i++) {
-        test_array[i] = i;
+    bench_summarize(samples, BENCH_TRIALS, out);
+}
+
+// Plain stdout so the rows can be grepped out of the log and fed to a plotter
+static void bench_emit_csv(const char* name, const char* region, size_t working_set,
+                           const bench_summary_t* s) {
+    printf("BENCH_CSV,%s,%s,%u,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", name, region,
+           (unsigned)working_set, BENCH_TRIALS, s->median, s->p95, s->mean, s->ci95, s->min);
+}
+
+typedef struct {
+    uint32_t* ring;
+    uint32_t start;
+} chase_ctx_t;
+
+static float chase_trial(void* arg) {
+    chase_ctx_t* c = (chase_ctx_t*)arg;
+    uint32_t idx = c->start;
+    
+    uint64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_ACCESSES; i++) {
+        idx = c->ring[idx];
     }
+    uint64_t elapsed = esp_timer_get_time() - start;
     
-    // Sequential access test
-    uint64_t start_time = esp_timer_get_time();
-    volatile uint32_t sum = 0;
+    bench_sink = idx;
+    return elapsed * 1000.0f / BENCH_ACCESSES;
+}
+
+// Link one node per BENCH_NODE_STRIDE bytes into a single cycle, either in
+// address order or in a random order (Sattolo's shuffle)
+static bool chase_build(uint32_t* ring, size_t bytes, bool random_order) {
+    const uint32_t words_per_node = BENCH_NODE_STRIDE / sizeof(uint32_t);
+    uint32_t nodes = bytes / BENCH_NODE_STRIDE;
+    uint32_t* order = malloc(nodes * sizeof(uint32_t));
+    if (!order || nodes < 2) {
+        free(order);
+        return false;
+    }
     
-    for (int iter = 0; iter < iterations; iter++) {
-        for (size_t i = 0; i < array_size; i++) {
-            sum += test_array[i];
+    for (uint32_t i = 0; i < nodes; i++) {
+        order[i] = i;
+    }
+    if (random_order) {
+        uint32_t x = esp_random() | 1;
+        for (uint32_t i = nodes - 1; i > 0; i--) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;   // xorshift32
+            uint32_t j = x % i;
+            uint32_t t = order[i]; order[i] = order[j]; order[j] = t;
         }
     }
     
-    uint64_t sequential_time = esp_timer_get_time() - start_time;
+    for (uint32_t i = 0; i < nodes; i++) {
+        ring[order[i] * words_per_node] = order[(i + 1) % nodes] * words_per_node;
+    }
     
-    // Random access test
-    start_time = esp_timer_get_time();
-    sum = 0;
+    free(order);
+    return true;
+}
+
+typedef struct {
+    uint32_t* matrix;
+    size_t n;
+    bool column_major;
+} matrix_ctx_t;
+
+static float matrix_trial(void* arg) {
+    matrix_ctx_t* m = (matrix_ctx_t*)arg;
+    uint32_t sum = 0;
+    
+    uint64_t start = esp_timer_get_time();
+    if (m->column_major) {
+        for (size_t col = 0; col < m->n; col++) {
+            for (size_t row = 0; row < m->n; row++) {
+                sum += m->matrix[row * m->n + col];
+            }
+        }
+    } else {
+        for (size_t row = 0; row < m->n; row++) {
+            for (size_t col = 0; col < m->n; col++) {
+                sum += m->matrix[row * m->n + col];
+            }
+        }
+    }
+    uint64_t elapsed = esp_timer_get_time() - start;
     
-    for (int iter = 0; iter < iterations; iter++) {
-        for (size_t i = 0; i < array_size; i++) {
-            size_t random_index = esp_random() % array_size;
-            sum += test_array[random_index];
+    bench_sink = sum;
+    return elapsed * 1000.0f / (m->n * m->n);
+}
+
+static void bench_log(const char* name, const bench_summary_t* s) {
+    ESP_LOGI(TAG, "  %-13s median %7.2f ns  p95 %7.2f ns  mean %7.2f ± %.2f ns",
+             name, s->median, s->p95, s->mean, s->ci95);
+}
+
+// Latency per dependent load as the working set grows; the steps show
+// where the cache, internal SRAM and PSRAM boundaries are
+void run_working_set_sweep(void) {
+    static const struct {
+        const char* name;
+        uint32_t caps;
+    } regions[] = {
+        {"internal", MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+#ifndef CONFIG_IDF_TARGET_LINUX
+        {"spiram", MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT},
+#endif
+    };
+    
+    ESP_LOGI(TAG, "\n📏 ═══ WORKING SET SWEEP ═══");
+    printf("BENCH_CSV,benchmark,region,working_set_bytes,trials,median_ns,p95_ns,mean_ns,ci95_ns,min_ns\n");
+    
+    for (int r = 0; r < sizeof(regions) / sizeof(regions[0]); r++) {
+        for (size_t ws = BENCH_MIN_WS_BYTES; ws <= BENCH_MAX_WS_BYTES; ws *= 2) {
+            uint32_t* ring = heap_caps_aligned_alloc(BENCH_NODE_STRIDE, ws, regions[r].caps);
+            if (!ring) {
+                ESP_LOGI(TAG, "%s: no %d byte block, sweep stops here", regions[r].name, ws);
+                break;
+            }
+            
+            for (int random_order = 0; random_order <= 1; random_order++) {
+                const char* name = random_order ? "chase_random" : "chase_sequential";
+                chase_ctx_t ctx = {ring, 0};
+                bench_summary_t summary;
+                
+                if (!chase_build(ring, ws, random_order)) continue;
+                bench_run(chase_trial, &ctx, &summary);
+                bench_emit_csv(name, regions[r].name, ws, &summary);
+                ESP_LOGI(TAG, "%-8s %7d B %-17s median %6.2f ns  p95 %6.2f ns",
+                         regions[r].name, ws, name, summary.median, summary.p95);
+            }
+            
+            heap_caps_free(ring);
+            vTaskDelay(1);   // Let the idle task run between rows
         }
     }
     
-    uint64_t random_time = esp_timer_get_time() - start_time;
+    ESP_LOGI(TAG, "═══════════════════════════════════════");
+}
+
+// Memory access pattern optimization
+void optimize_memory_access_patterns(void) {
+    ESP_LOGI(TAG, "\n⚡ ═══ MEMORY ACCESS OPTIMIZATION ═══");
     
-    ESP_LOGI(TAG, "Access Pattern Performance (%d iterations):", iterations);
-    ESP_LOGI(TAG, "  Sequential: %llu μs", sequential_time);
-    ESP_LOGI(TAG, "  Random:     %llu μs", random_time);
-    ESP_LOGI(TAG, "  Speedup:    %.2fx (sequential vs random)", 
-             (float)random_time / sequential_time);
+    const size_t array_bytes = 4096;
+    bench_summary_t sequential, random, row_major, col_major;
     
-    aligned_free(test_array);
+    // Test 1: Sequential vs Random access
+    uint32_t* test_array = aligned_pool_malloc(array_bytes, 32, MALLOC_CAP_8BIT);
+    if (!test_array) {
+        ESP_LOGE(TAG, "Failed to allocate test array");
+        return;
+    }
+    
+    chase_ctx_t chase = {test_array, 0};
+    chase_build(test_array, array_bytes, false);
+    bench_run(chase_trial, &chase, &sequential);
+    chase_build(test_array, array_bytes, true);
+    bench_run(chase_trial, &chase, &random);
+    
+    ESP_LOGI(TAG, "Access Pattern Performance (%d trials x %d loads, %d B):",
+             BENCH_TRIALS, BENCH_ACCESSES, array_bytes);
+    bench_log("Sequential:", &sequential);
+    bench_log("Random:", &random);
+    ESP_LOGI(TAG, "  Speedup:    %.2fx (sequential vs random, medians)", 
+             random.median / sequential.median);
+    
+    aligned_pool_free(test_array);
     
     // Test 2: Cache-friendly vs Cache-unfriendly access
     const size_t matrix_size = 128;
-    uint32_t* matrix = aligned_malloc(matrix_size * matrix_size * sizeof(uint32_t), 64);
+    uint32_t* matrix = aligned_pool_malloc(matrix_size * matrix_size * sizeof(uint32_t), 64, MALLOC_CAP_8BIT);
     
     if (matrix) {
-        // Row-major access (cache-friendly)
-        start_time = esp_timer_get_time();
-        sum = 0;
-        
-        for (size_t row = 0; row < matrix_size; row++) {
-            for (size_t col = 0; col < matrix_size; col++) {
-                sum += matrix[row * matrix_size + col];
-            }
+        for (size_t i = 0; i < matrix_size * matrix_size; i++) {
+            matrix[i] = i;
         }
         
-        uint64_t row_major_time = esp_timer_get_time() - start_time;
+        matrix_ctx_t ctx = {matrix, matrix_size, false};
+        bench_run(matrix_trial, &ctx, &row_major);
+        ctx.column_major = true;
+        bench_run(matrix_trial, &ctx, &col_major);
         
-        // Column-major access (cache-unfriendly)
-        start_time = esp_timer_get_time();
-        sum = 0;
-        
-        for (size_t col = 0; col < matrix_size; col++) {
-            for (size_t row = 0; row < matrix_size; row++) {
-                sum += matrix[row * matrix_size + col];
-            }
-        }
-        
-        uint64_t col_major_time = esp_timer_get_time() - start_time;
-        
-        ESP_LOGI(TAG, "Matrix Access (%dx%d):", matrix_size, matrix_size);
-        ESP_LOGI(TAG, "  Row-major:    %llu μs (cache-friendly)", row_major_time);
-        ESP_LOGI(TAG, "  Column-major: %llu μs (cache-unfriendly)", col_major_time);
+        ESP_LOGI(TAG, "Matrix Access (%dx%d, per element):", matrix_size, matrix_size);
+        bench_log("Row-major:", &row_major);
+        bench_log("Column-major:", &col_major);
         ESP_LOGI(TAG, "  Performance:  %.2fx better with row-major", 
-                 (float)col_major_time / row_major_time);
+                 col_major.median / row_major.median);
         
-        aligned_free(matrix);
+        aligned_pool_free(matrix);
     }
     
     ESP_LOGI(TAG, "═══════════════════════════════════════");
@@ -402,11 +1132,26 @@ void benchmark_allocation_strategies(void) {
     
     uint64_t static_time = esp_timer_get_time() - start_time;
     
+    // Segregated-fit template pools
+    start_time = esp_timer_get_time();
+    
+    for (int i = 0; i < iterations; i++) {
+        void* ptr = template_malloc(test_size);
+        if (ptr) {
+            memset(ptr, 0xFF, test_size);
+            template_free(ptr);
+        }
+    }
+    
+    uint64_t template_time = esp_timer_get_time() - start_time;
+    
     ESP_LOGI(TAG, "Allocation Benchmark (%d iterations, %d bytes):", iterations, test_size);
     ESP_LOGI(TAG, "  malloc/free: %llu μs (%.2f μs per operation)", 
              malloc_time, (float)malloc_time / (iterations * 2));
     ESP_LOGI(TAG, "  static pool: %llu μs (%.2f μs per operation)", 
              static_time, (float)static_time / (iterations * 2));
+    ESP_LOGI(TAG, "  template:    %llu μs (%.2f μs per operation)", 
+             template_time, (float)template_time / (iterations * 2));
     
     if (static_time < malloc_time) {
         ESP_LOGI(TAG, "  Static is %.2fx faster!", (float)malloc_time / static_time);
@@ -438,34 +1183,230 @@ void benchmark_allocation_strategies(void) {
     
     uint64_t aligned_time = esp_timer_get_time() - start_time;
     
-    ESP_LOGI(TAG, "Alignment Benchmark:");
-    ESP_LOGI(TAG, "  Unaligned: %llu μs", unaligned_time);
-    ESP_LOGI(TAG, "  Aligned:   %llu μs", aligned_time);
+    start_time = esp_timer_get_time();
+    
+    for (int i = 0; i < iterations / 2; i++) {
+        void* ptr = aligned_pool_malloc(test_size, 32, MALLOC_CAP_8BIT);
+        if (ptr) {
+            memset(ptr, 0xAA, test_size);
+            aligned_pool_free(ptr);
+        }
+    }
+    
+    uint64_t pooled_time = esp_timer_get_time() - start_time;
+    
+    ESP_LOGI(TAG, "Alignment Benchmark (%d iterations):", iterations / 2);
+    ESP_LOGI(TAG, "  Unaligned: %llu μs (%.2f μs per pair)", 
+             unaligned_time, (float)unaligned_time / (iterations / 2));
+    ESP_LOGI(TAG, "  Aligned:   %llu μs (%.2f μs per pair, %d B slack each)", 
+             aligned_time, (float)aligned_time / (iterations / 2), 32 + sizeof(void*));
+    ESP_LOGI(TAG, "  Pooled:    %llu μs (%.2f μs per pair, no slack)", 
+             pooled_time, (float)pooled_time / (iterations / 2));
+    ESP_LOGI(TAG, "  LED events posted %lu", activity_posted);
     
     ESP_LOGI(TAG, "═══════════════════════════════════════");
 }
 
-// Static task creation demonstration
-BaseType_t create_static_task(TaskFunction_t task_function, const char* name, 
-                             UBaseType_t priority, void* parameters) {
-    if (next_task_slot >= MAX_TASKS) {
-        ESP_LOGE(TAG, "No more static task slots available");
-        return pdFAIL;
+#ifndef CONFIG_IDF_TARGET_LINUX
+// Runs once per idle loop, after that loop's prvCheckTasksWaitingTermination()
+static bool task_slab_idle_hook(void) {
+    __atomic_fetch_add(&task_slab.idle_passes[xPortGetCoreID()], 1, __ATOMIC_RELAXED);
+    return true;
+}
+#endif
+
+static inline uint32_t task_slab_idle_passes(int core) {
+#ifdef CONFIG_IDF_TARGET_LINUX
+    return xTaskGetTickCount();   // Host port: no idle hooks, a tick stands in for a pass
+#else
+    return __atomic_load_n(&task_slab.idle_passes[core], __ATOMIC_RELAXED);
+#endif
+}
+
+// Task slab: carve the stack storage into per-class free lists
+void task_slab_init(void) {
+    StackType_t* next = task_slab_storage;
+    int slot = 0;
+    
+    for (int c = 0; c < TASK_SLAB_CLASS_COUNT; c++) {
+        task_slab_class_t* cls = &task_slab.classes[c];
+        cls->free_head = -1;
+        cls->min_headroom = cls->stack_depth * sizeof(StackType_t);
+        for (int i = 0; i < cls->count; i++, slot++) {
+            task_slot_t* s = &task_slab.slots[slot];
+            s->stack = next;
+            s->cls = c;
+            s->state = TASK_SLOT_FREE;
+            s->next_free = cls->free_head;
+            cls->free_head = slot;
+            next += cls->stack_depth;
+        }
+    }
+    
+#ifndef CONFIG_IDF_TARGET_LINUX
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        esp_register_freertos_idle_hook_for_cpu(task_slab_idle_hook, core);
+    }
+#endif
+}
+
+// Untouched bytes at the far end of the stack (stacks grow down on all ESP32 targets)
+static uint32_t task_slot_headroom(const task_slot_t* slot) {
+    const uint8_t* bytes = (const uint8_t*)slot->stack;
+    uint32_t limit = task_slab.classes[slot->cls].stack_depth * sizeof(StackType_t);
+    uint32_t headroom = 0;
+    while (headroom < limit && bytes[headroom] == TASK_SLAB_STACK_FILL) {
+        headroom++;
+    }
+    return headroom;
+}
+
+static void task_slab_release(task_slot_t* slot) {
+    task_slab_class_t* cls = &task_slab.classes[slot->cls];
+    uint32_t headroom = task_slot_headroom(slot);
+    
+    taskENTER_CRITICAL(&task_slab.lock);
+    if (slot->state == TASK_SLOT_FREE) {
+        // Another reaper got here first
+        taskEXIT_CRITICAL(&task_slab.lock);
+        return;
+    }
+    if (headroom < cls->min_headroom) {
+        cls->min_headroom = headroom;
+    }
+    slot->state = TASK_SLOT_FREE;
+    slot->next_free = cls->free_head;
+    cls->free_head = slot - task_slab.slots;
+    cls->in_use--;
+    taskEXIT_CRITICAL(&task_slab.lock);
+}
+
+static void task_slot_mark_exited(task_slot_t* slot) {
+    taskENTER_CRITICAL(&task_slab.lock);
+    if (slot->state == TASK_SLOT_RUNNING) {
+        slot->state = TASK_SLOT_EXITED;
+    }
+    taskEXIT_CRITICAL(&task_slab.lock);
+}
+
+#if CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS
+// Runs at the start of prvDeleteTCB, while teardown still uses the TCB, so it
+// only flags a task deleted by another task; task_slab_reap() recycles it later
+static void task_slab_exited(int index, void* data) {
+    task_slot_mark_exited((task_slot_t*)data);
+}
+#endif
+
+// Every core has looped through its idle task since reclaiming began, so any
+// prvDeleteTCB of this TCB, in an idle task or in the deleting task, is done
+static bool task_slot_quiesced(const task_slot_t* slot) {
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        if (task_slab_idle_passes(core) - slot->idle_mark[core] < TASK_SLAB_IDLE_PASSES) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Move exited slots towards the free lists: EXITED -> RECLAIMING once the
+// task is off every list, RECLAIMING -> FREE once its teardown has finished
+static void task_slab_reap(void) {
+    for (int i = 0; i < TASK_SLAB_SLOTS; i++) {
+        task_slot_t* slot = &task_slab.slots[i];
+        uint8_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+        
+        if (state == TASK_SLOT_EXITED &&
+            eTaskGetState((TaskHandle_t)&slot->tcb) == eDeleted) {
+            taskENTER_CRITICAL(&task_slab.lock);
+            if (slot->state == TASK_SLOT_EXITED) {
+                for (int core = 0; core < portNUM_PROCESSORS; core++) {
+                    slot->idle_mark[core] = task_slab_idle_passes(core);
+                }
+                slot->state = TASK_SLOT_RECLAIMING;
+            }
+            taskEXIT_CRITICAL(&task_slab.lock);
+        } else if (state == TASK_SLOT_RECLAIMING && task_slot_quiesced(slot)) {
+            task_slab_release(slot);
+        }
+    }
+}
+
+static void task_slab_trampoline(void* pvParameters) {
+    task_slot_t* slot = (task_slot_t*)pvParameters;
+    
+#if CONFIG_FREERTOS_TLSP_DELETION_CALLBACKS
+    vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, TASK_SLAB_TLS_INDEX,
+                                                    slot, task_slab_exited);
+#endif
+    slot->entry(slot->arg);
+    
+    // The idle task still tears the TCB down after this; task_slab_reap()
+    // waits for that before the slot is handed out again
+    task_slot_mark_exited(slot);
+    vTaskDelete(NULL);
+}
+
+// Create a task on the smallest free stack class that fits stack_depth
+TaskHandle_t task_slab_create(TaskFunction_t task_function, const char* name,
+                              uint32_t stack_depth, UBaseType_t priority, void* parameters) {
+    task_slot_t* slot = NULL;
+    int wanted = -1;
+    
+    task_slab_reap();
+    
+    taskENTER_CRITICAL(&task_slab.lock);
+    for (int c = 0; c < TASK_SLAB_CLASS_COUNT; c++) {
+        task_slab_class_t* cls = &task_slab.classes[c];
+        if (stack_depth > cls->stack_depth) continue;
+        if (wanted < 0) wanted = c;
+        if (cls->free_head < 0) continue;
+        
+        slot = &task_slab.slots[cls->free_head];
+        cls->free_head = slot->next_free;
+        slot->state = TASK_SLOT_RUNNING;
+        cls->in_use++;
+        if (cls->in_use > cls->peak_in_use) {
+            cls->peak_in_use = cls->in_use;
+        }
+        cls->created++;
+        break;
+    }
+    if (!slot && wanted >= 0) {
+        task_slab.classes[wanted].exhausted++;
     }
+    taskEXIT_CRITICAL(&task_slab.lock);
     
-    TaskHandle_t task_handle = xTaskCreateStatic(
-        task_function,
-        name,
-        TASK_STACK_SIZE,
-        parameters,
-        priority,
-        task_stacks[next_task_slot],
-        &task_buffers[next_task_slot]
-    );
+    if (!slot) {
+        ESP_LOGE(TAG, "No task slab slot for '%s' (%lu stack)", name, stack_depth);
+        return NULL;
+    }
     
-    if (task_handle) {
-        ESP_LOGI(TAG, "✅ Created static task '%s' in slot %d", name, next_task_slot);
-        next_task_slot++;
+    slot->entry = task_function;
+    slot->arg = parameters;
+    TaskHandle_t handle = xTaskCreateStatic(task_slab_trampoline, name,
+                                            task_slab.classes[slot->cls].stack_depth,
+                                            slot, priority, slot->stack, &slot->tcb);
+    if (!handle) {
+        task_slab_release(slot);
+    }
+    return handle;
+}
+
+void print_task_slab_stats(void) {
+    ESP_LOGI(TAG, "Task Slab (in use/peak/slots, created, exhausted, min headroom):");
+    for (int c = 0; c < TASK_SLAB_CLASS_COUNT; c++) {
+        task_slab_class_t* cls = &task_slab.classes[c];
+        ESP_LOGI(TAG, "  %5lu B  %d/%d/%d, %lu created, %lu exhausted, %lu B headroom",
+                 cls->stack_depth * sizeof(StackType_t), cls->in_use, cls->peak_in_use,
+                 cls->count, cls->created, cls->exhausted, cls->min_headroom);
+    }
+}
+
+// Static task creation demonstration
+BaseType_t create_static_task(TaskFunction_t task_function, const char* name, 
+                             UBaseType_t priority, void* parameters) {
+    if (task_slab_create(task_function, name, TASK_STACK_SIZE, priority, parameters)) {
+        ESP_LOGI(TAG, "✅ Created static task '%s' from the task slab", name);
         return pdPASS;
     } else {
         ESP_LOGE(TAG, "❌ Failed to create static task '%s'", name);
@@ -473,6 +1414,42 @@ BaseType_t create_static_task(TaskFunction_t task_function, const char* name,
     }
 }
 
+// Short-lived worker: a little stack work, then return and give the slot back
+static void slab_worker(void *pvParameters) {
+    uint8_t scratch[512];
+    uint32_t seed = (uint32_t)(uintptr_t)pvParameters;
+    volatile uint32_t checksum = 0;
+    
+    for (int i = 0; i < sizeof(scratch); i++) {
+        scratch[i] = (uint8_t)(seed * 31 + i);
+        checksum += scratch[i];
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+}
+
+void task_slab_test_task(void *pvParameters) {
+    uint32_t bursts = 0;
+    
+    ESP_LOGI(TAG, "🧵 Task slab test task started");
+    
+    while (1) {
+        int started = 0;
+        for (int i = 0; i < TASK_SLAB_WORKER_BURST; i++) {
+            if (task_slab_create(slab_worker, "SlabWorker", 1536, 3,
+                                 (void*)(uintptr_t)(bursts * TASK_SLAB_WORKER_BURST + i))) {
+                started++;
+            }
+        }
+        if (started < TASK_SLAB_WORKER_BURST) {
+            ESP_LOGW(TAG, "🧵 Burst %lu started only %d/%d workers",
+                     bursts, started, TASK_SLAB_WORKER_BURST);
+        }
+        bursts++;
+        
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
 // Test tasks
 void optimization_test_task(void *pvParameters) {
     ESP_LOGI(TAG, "🧪 Optimization test task started");
@@ -498,16 +1475,77 @@ void optimization_test_task(void *pvParameters) {
     }
 }
 
+// A chatty logger holds buffers until its quota says no; its pressure
+// callback drops the oldest half. The network side keeps allocating from
+// its own quota and never sees a denial.
+typedef struct {
+    void* held[BUDGET_NOISY_HELD];
+    int head;
+    int count;
+} noisy_log_state_t;
+
+static bool noisy_log_pressure(budget_subsystem_t id, size_t shortfall, void* arg) {
+    noisy_log_state_t* state = (noisy_log_state_t*)arg;
+    int drop = (state->count + 1) / 2;
+    
+    for (int i = 0; i < drop; i++) {
+        int oldest = (state->head - state->count + BUDGET_NOISY_HELD) % BUDGET_NOISY_HELD;
+        budget_free(id, state->held[oldest], 512);
+        state->count--;
+    }
+    return drop > 0;
+}
+
+void budget_test_task(void *pvParameters) {
+    static noisy_log_state_t noisy = {0};
+    void* packets[8] = {NULL};
+    
+    ESP_LOGI(TAG, "💰 Budget test task started");
+    budget_set_pressure_callback(BUDGET_LOGGING, noisy_log_pressure, &noisy);
+    
+    while (1) {
+        // Noisy subsystem: a burst of log buffers
+        for (int i = 0; i < BUDGET_NOISY_HELD; i++) {
+            void* buf = budget_malloc(BUDGET_LOGGING, 512, false);
+            if (!buf) break;
+            if (noisy.count == BUDGET_NOISY_HELD) {
+                budget_free(BUDGET_LOGGING, noisy.held[noisy.head], 512);
+                noisy.count--;
+            }
+            noisy.held[noisy.head] = buf;
+            noisy.head = (noisy.head + 1) % BUDGET_NOISY_HELD;
+            noisy.count++;
+        }
+        
+        // Network: packet buffers from its own quota, DMA-capable
+        int got = 0;
+        for (int i = 0; i < 8; i++) {
+            packets[i] = budget_aligned_malloc(BUDGET_NETWORK, 1536, 32, MALLOC_CAP_DMA);
+            if (packets[i]) got++;
+        }
+        if (got < 8) {
+            ESP_LOGW(TAG, "💰 Network got only %d/8 packet buffers", got);
+        }
+        for (int i = 0; i < 8; i++) {
+            budget_aligned_free(BUDGET_NETWORK, packets[i], 1536);
+            packets[i] = NULL;
+        }
+        
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
 void memory_usage_test_task(void *pvParameters) {
     ESP_LOGI(TAG, "📊 Memory usage test task started");
     
+    // Charged to the system budget like any other subsystem's pool use
     while (1) {
         // Test static buffer allocation
         void* static_buffers[4] = {NULL};
         
         ESP_LOGI(TAG, "📊 Testing static buffer allocation...");
         for (int i = 0; i < 4; i++) {
-            static_buffers[i] = allocate_static_buffer();
+            static_buffers[i] = budget_static_buffer(BUDGET_SYSTEM);
             if (static_buffers[i]) {
                 ESP_LOGI(TAG, "  Allocated static buffer %d: %p", i, static_buffers[i]);
                 memset(static_buffers[i], 0x55, STATIC_BUFFER_SIZE);
@@ -519,18 +1557,20 @@ void memory_usage_test_task(void *pvParameters) {
         // Free static buffers
         for (int i = 0; i < 4; i++) {
             if (static_buffers[i]) {
-                free_static_buffer(static_buffers[i]);
+                budget_free_static_buffer(BUDGET_SYSTEM, static_buffers[i]);
                 ESP_LOGI(TAG, "  Freed static buffer %d", i);
             }
         }
         
         // Test aligned allocations
         ESP_LOGI(TAG, "📊 Testing aligned allocations...");
+        static const size_t aligned_sizes[3] = {1024, 2048, 4096};
         void* aligned_ptrs[3];
         
-        aligned_ptrs[0] = aligned_malloc(1024, 16);
-        aligned_ptrs[1] = aligned_malloc(2048, 32);
-        aligned_ptrs[2] = aligned_malloc(4096, 64);
+        aligned_ptrs[0] = budget_aligned_malloc(BUDGET_SYSTEM, aligned_sizes[0], 16, MALLOC_CAP_8BIT);
+        aligned_ptrs[1] = budget_aligned_malloc(BUDGET_SYSTEM, aligned_sizes[1], 32, MALLOC_CAP_8BIT);
+        aligned_ptrs[2] = budget_aligned_malloc(BUDGET_SYSTEM, aligned_sizes[2], 64,
+                                                MALLOC_CAP_DMA);   // DMA descriptor-ready
         
         for (int i = 0; i < 3; i++) {
             if (aligned_ptrs[i]) {
@@ -543,9 +1583,7 @@ void memory_usage_test_task(void *pvParameters) {
         vTaskDelay(pdMS_TO_TICKS(3000));
         
         for (int i = 0; i < 3; i++) {
-            if (aligned_ptrs[i]) {
-                aligned_free(aligned_ptrs[i]);
-            }
+            budget_aligned_free(BUDGET_SYSTEM, aligned_ptrs[i], aligned_sizes[i]);
         }
         
         vTaskDelay(pdMS_TO_TICKS(10000)); // Test every 10 seconds
@@ -566,6 +1604,10 @@ void optimization_monitor_task(void *pvParameters) {
         ESP_LOGI(TAG, "Memory Saved:            %d bytes (%.1f KB)", 
                  opt_stats.memory_saved_bytes, opt_stats.memory_saved_bytes / 1024.0);
         ESP_LOGI(TAG, "Time Saved:              %llu μs", opt_stats.allocation_time_saved);
+        print_template_pool_stats();
+        print_aligned_pool_stats();
+        print_budget_stats();
+        print_task_slab_stats();
         
         // Update LED based on savings
         if (opt_stats.memory_saved_bytes > 1024) {
@@ -601,12 +1643,12 @@ void app_main(void) {
     gpio_set_level(LED_MEMORY_SAVING, 0);
     gpio_set_level(LED_OPTIMIZATION, 0);
     
-    // Create mutex for static buffer management
-    static_buffer_mutex = xSemaphoreCreateMutex();
-    if (!static_buffer_mutex) {
-        ESP_LOGE(TAG, "Failed to create static buffer mutex!");
-        return;
-    }
+    xTaskCreate(activity_indicator_task, "ActivityLED", 2048, NULL,
+                ACTIVITY_TASK_PRIORITY, &activity_task);
+    
+    static_buffers_init();
+    template_pools_init();
+    task_slab_init();
     
     ESP_LOGI(TAG, "Static memory system initialized");
     
@@ -616,13 +1658,15 @@ void app_main(void) {
     // Demonstrate struct optimization
     demonstrate_struct_optimization();
     
+    run_working_set_sweep();
+    
     ESP_LOGI(TAG, "\n🏗️ ═══ STATIC ALLOCATION SETUP ═══");
     ESP_LOGI(TAG, "Static buffers: %d × %d bytes = %d KB total",
              STATIC_BUFFER_COUNT, STATIC_BUFFER_SIZE,
              (STATIC_BUFFER_COUNT * STATIC_BUFFER_SIZE) / 1024);
-    ESP_LOGI(TAG, "Task stacks: %d × %d bytes = %d KB total",
-             MAX_TASKS, TASK_STACK_SIZE * sizeof(StackType_t),
-             (MAX_TASKS * TASK_STACK_SIZE * sizeof(StackType_t)) / 1024);
+    ESP_LOGI(TAG, "Task slab: %d slots in %d stack classes = %d KB total",
+             TASK_SLAB_SLOTS, TASK_SLAB_CLASS_COUNT,
+             (TASK_SLAB_DEPTH_TOTAL * sizeof(StackType_t)) / 1024);
     ESP_LOGI(TAG, "═══════════════════════════════════════");
     
     // Create tasks using static allocation
@@ -634,6 +1678,8 @@ void app_main(void) {
     
     // Use regular dynamic allocation for monitor task
     xTaskCreate(optimization_monitor_task, "OptMonitor", 3072, NULL, 6, NULL);
+    xTaskCreate(budget_test_task, "BudgetTest", 3072, NULL, 4, NULL);
+    xTaskCreate(task_slab_test_task, "SlabTest", 2048, NULL, 4, NULL);
     
     ESP_LOGI(TAG, "All tasks created successfully");
     
@@ -646,9 +1692,12 @@ void app_main(void) {
     
     ESP_LOGI(TAG, "\n🔧 Optimization Features:");
     ESP_LOGI(TAG, "  • Static vs Dynamic Allocation Comparison");
-    ESP_LOGI(TAG, "  • Memory Alignment Optimization");
+    ESP_LOGI(TAG, "  • Memory Alignment Optimization (line-aligned pools, DMA)");
     ESP_LOGI(TAG, "  • Struct Packing Optimization");
     ESP_LOGI(TAG, "  • Memory Access Pattern Analysis");
+    ESP_LOGI(TAG, "  • Working-set Sweep with CSV Output");
+    ESP_LOGI(TAG, "  • Per-subsystem Memory Budgets");
+    ESP_LOGI(TAG, "  • Recycled Static Task Slab");
     ESP_LOGI(TAG, "  • Allocation Performance Benchmarking");
     ESP_LOGI(TAG, "  • Memory Region Analysis");
     
@@ -686,35 +1735,6 @@ void calculate_optimization_impact(void) {
 
 
 
-// Template-based memory pools for common sizes
-typedef struct {
-    size_t sizes[8];      // Common allocation sizes
-    void* pools[8];       // Corresponding pools
-    int pool_counts[8];   // Number of blocks per pool
-    int usage_counts[8];  // Current usage
-} template_pool_system_t;
-
-template_pool_system_t template_pools = {
-    .sizes = {16, 32, 64, 128, 256, 512, 1024, 2048},
-    .pool_counts = {64, 32, 16, 16, 8, 8, 4, 2}
-};
-
-void* template_malloc(size_t size) {
-    // Find best-fit template size
-    for (int i = 0; i < 8; i++) {
-        if (size <= template_pools.sizes[i]) {
-            // Allocate from corresponding pool
-            ESP_LOGI(TAG, "🎯 Template allocation: %d bytes from %d-byte pool", 
-                     size, template_pools.sizes[i]);
-            return NULL; // Implementation would allocate from pool
-        }
-    }
-    
-    // Fall back to regular allocation
-    return malloc(size);
-}
-
-
 // Guidelines for memory-constrained embedded systems
 void memory_optimization_guidelines(void) {
     ESP_LOGI(TAG, "\n💡 Memory Optimization Guidelines:");
@@ -729,23 +1749,3 @@ void memory_optimization_guidelines(void) {
     ESP_LOGI(TAG, "9. Implement lazy loading for large datasets");
     ESP_LOGI(TAG, "10. Regular memory audits and leak detection");
 }
-
-// Memory budget tracking
-typedef struct {
-    size_t total_budget;
-    size_t allocated;
-    size_t reserved;
-    size_t emergency_reserve;
-} memory_budget_t;
-
-void track_memory_budget(memory_budget_t* budget, size_t allocation) {
-    budget->allocated += allocation;
-    
-    float usage_percent = ((float)budget->allocated / budget->total_budget) * 100.0;
-    
-    if (usage_percent > 90.0) {
-        ESP_LOGW(TAG, "⚠️ Memory budget critical: %.1f%% used", usage_percent);
-    } else if (usage_percent > 75.0) {
-        ESP_LOGW(TAG, "⚠️ Memory budget warning: %.1f%% used", usage_percent);
-    }
-}
\ No newline at end of file
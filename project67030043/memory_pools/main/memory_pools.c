@@ -1,5 +1,7 @@
 #include <stdio.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include "freertos/FreeRTOS.h"
@@ -10,7 +12,11 @@
 #include "esp_heap_caps.h"
 #include "esp_timer.h"
 #include "esp_system.h"
-#include "driver/gpio.h"
+#include "esp_rom_crc.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+
+#include "gpio_compat.h"
 
 static const char *TAG = "MEM_POOLS";
 
@@ -34,11 +40,61 @@ static const char *TAG = "MEM_POOLS";
 #define HUGE_POOL_BLOCK_SIZE    4096
 #define HUGE_POOL_BLOCK_COUNT   4
 
+// Contention benchmark: mutex vs lock-free pool under several producers
+#define CONTENTION_BENCH_WORKERS    4
+#define CONTENTION_BENCH_PAIRS      1000   // alloc/free pairs per worker
+#define CONTENTION_BENCH_HELD       4      // blocks each worker keeps in flight
+
+// Per-core block caches in front of the shared pools
+#define POOL_CACHE_MAGAZINE_SIZE    8      // blocks a core may hold per pool
+#define POOL_CACHE_BATCH            4      // blocks moved per refill/flush
+#define POOL_CACHE_MIN_BLOCKS       (4 * POOL_CACHE_BATCH) // smaller pools bypass the magazines
+
+// Activity LEDs are pulsed by a background task, never on the allocation path
+#define ACTIVITY_RING_SIZE          32     // pending LED events
+#define ACTIVITY_PULSE_MS           50
+#define ACTIVITY_TASK_PRIORITY      1
+
+// Allocation latency benchmark (smart_pool_malloc, LEDs enabled)
+#define LATENCY_BENCH_SAMPLES       1000
+
+// Zero-copy packet buffers (see packet_buffer_t)
+#define PACKET_BUFFER_SIZE          1500   // Standard Ethernet MTU
+#define PACKET_BUFFER_COUNT         32
+#define PACKET_HEADROOM             64     // Room for prepended protocol headers
+#define PACKET_QUEUE_DEPTH          8
+#define PACKET_BENCH_PACKETS        500
+
+// Size profiling and runtime pool configuration
+#define POOL_MAX_BLOCK_SIZE         8192   // Largest block a config blob may ask for
+#define POOL_PROFILE_WINDOW_MS      30000  // Histogram window after boot
+#define POOL_PROFILE_SAVE           0      // Store the recommendation in NVS for next boot
+#define POOL_CONFIG_NVS_NAMESPACE   "mem_pools"
+#define POOL_CONFIG_NVS_KEY         "config"
+
+// Pool allocation mode
+typedef enum {
+    POOL_MODE_MUTEX = 0,   // Free list guarded by a FreeRTOS mutex
+    POOL_MODE_LOCKFREE,    // CAS on an ABA-tagged free list head
+    POOL_MODE_BITMAP       // usage_bitmap + summary, ctz search, multi-block runs
+} pool_mode_t;
+
+// Where block metadata lives
+typedef enum {
+    POOL_LAYOUT_INLINE = 0, // memory_block_t header in front of every payload
+    POOL_LAYOUT_OOB         // block_meta_t side table, payloads densely packed
+} pool_layout_t;
+
 // Pool management structures
-typedef struct memory_block {
-    struct memory_block* next;
+typedef struct {
     uint32_t magic;        // For corruption detection
+    uint32_t link;         // Free list: next index + 1, 0 = end; bitmap mode: span
+} block_meta_t;
+
+typedef struct memory_block {
+    block_meta_t meta;
     uint32_t pool_id;      // Which pool this block belongs to
+    uint32_t index;        // Slot number, cross-checked on free
     uint64_t alloc_time;   // When was this allocated
 } memory_block_t;
 
@@ -48,11 +104,19 @@ typedef struct {
     size_t block_count;
     size_t alignment;
     uint32_t caps;
+    pool_mode_t mode;
+    pool_layout_t layout;
+    size_t stride;         // Distance between payloads, computed once at init
+    size_t payload_offset; // Inline header size, 0 for POOL_LAYOUT_OOB
     
     // Pool memory
     void* pool_memory;
-    memory_block_t* free_list;
+    block_meta_t* meta_table; // POOL_LAYOUT_OOB only, indexed by block number
+    uint32_t free_head;    // POOL_MODE_MUTEX: index + 1, 0 = empty
+    uint32_t lf_head;      // POOL_MODE_LOCKFREE: tag << 16 | (index + 1), 0 = empty
+    uint32_t bad_head;     // Quarantined blocks: index + 1, 0 = empty (push only)
     uint32_t* usage_bitmap;
+    uint32_t* free_summary; // POOL_MODE_BITMAP: bit w set while usage_bitmap[w] has a free bit
     
     // Statistics
     size_t allocated_blocks;
@@ -62,6 +126,7 @@ typedef struct {
     uint64_t allocation_time_total;
     uint64_t deallocation_time_total;
     uint32_t allocation_failures;
+    uint32_t quarantined;  // Corrupt blocks taken out of service
     
     // Synchronization
     SemaphoreHandle_t mutex;
@@ -79,8 +144,22 @@ typedef enum {
     POOL_COUNT
 } pool_type_t;
 
+// Per-core magazine: a small LIFO of free blocks taken from one pool
+typedef struct {
+    portMUX_TYPE lock;     // Only contended if a task migrates mid-operation
+    void* blocks[POOL_CACHE_MAGAZINE_SIZE];
+    uint32_t count;
+    
+    // Statistics
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t refills;      // Batches pulled from the shared pool
+    uint32_t flushes;      // Batches returned to the shared pool
+} pool_cache_t;
+
 // Global pools
 static memory_pool_t pools[POOL_COUNT];
+static pool_cache_t pool_caches[portNUM_PROCESSORS][POOL_COUNT];
 static bool pools_initialized = false;
 
 // Pool configuration
@@ -90,23 +169,269 @@ typedef struct {
     size_t block_count;
     uint32_t caps;
     gpio_num_t led_pin;
+    pool_mode_t mode;
+    pool_layout_t layout;
 } pool_config_t;
 
-static const pool_config_t pool_configs[POOL_COUNT] = {
-    {"Small",  SMALL_POOL_BLOCK_SIZE,  SMALL_POOL_BLOCK_COUNT,  MALLOC_CAP_INTERNAL, LED_SMALL_POOL},
-    {"Medium", MEDIUM_POOL_BLOCK_SIZE, MEDIUM_POOL_BLOCK_COUNT, MALLOC_CAP_INTERNAL, LED_MEDIUM_POOL},
-    {"Large",  LARGE_POOL_BLOCK_SIZE,  LARGE_POOL_BLOCK_COUNT,  MALLOC_CAP_DEFAULT,  LED_LARGE_POOL},
-    {"Huge",   HUGE_POOL_BLOCK_SIZE,   HUGE_POOL_BLOCK_COUNT,   MALLOC_CAP_SPIRAM,   LED_POOL_FULL}
+// Compile-time defaults; a config blob from NVS may replace sizes, counts,
+// caps and modes before the pools are initialized
+static pool_config_t pool_configs[POOL_COUNT] = {
+    {"Small",  SMALL_POOL_BLOCK_SIZE,  SMALL_POOL_BLOCK_COUNT,  MALLOC_CAP_INTERNAL, LED_SMALL_POOL,  POOL_MODE_LOCKFREE, POOL_LAYOUT_OOB},
+    {"Medium", MEDIUM_POOL_BLOCK_SIZE, MEDIUM_POOL_BLOCK_COUNT, MALLOC_CAP_INTERNAL, LED_MEDIUM_POOL, POOL_MODE_LOCKFREE, POOL_LAYOUT_OOB},
+    {"Large",  LARGE_POOL_BLOCK_SIZE,  LARGE_POOL_BLOCK_COUNT,  MALLOC_CAP_DEFAULT,  LED_LARGE_POOL,  POOL_MODE_MUTEX,    POOL_LAYOUT_INLINE},
+    {"Huge",   HUGE_POOL_BLOCK_SIZE,   HUGE_POOL_BLOCK_COUNT,   MALLOC_CAP_SPIRAM,   LED_POOL_FULL,   POOL_MODE_BITMAP,   POOL_LAYOUT_OOB}
 };
 
+// Size-class routing: request size rounded up to 16 bytes indexes the
+// smallest pool that fits, so smart_pool_malloc() never walks pools[]
+#define SIZE_CLASS_SHIFT   4
+#define SIZE_CLASS_SLOT(size)  (((size) + (1 << SIZE_CLASS_SHIFT) - 1) >> SIZE_CLASS_SHIFT)
+#define SIZE_CLASS_SLOTS   (SIZE_CLASS_SLOT(POOL_MAX_BLOCK_SIZE) + 1)
+
+_Static_assert(SMALL_POOL_BLOCK_SIZE < MEDIUM_POOL_BLOCK_SIZE &&
+               MEDIUM_POOL_BLOCK_SIZE < LARGE_POOL_BLOCK_SIZE &&
+               LARGE_POOL_BLOCK_SIZE < HUGE_POOL_BLOCK_SIZE &&
+               HUGE_POOL_BLOCK_SIZE <= POOL_MAX_BLOCK_SIZE,
+               "pool_configs must be ordered by block size");
+_Static_assert((SMALL_POOL_BLOCK_SIZE | MEDIUM_POOL_BLOCK_SIZE | LARGE_POOL_BLOCK_SIZE |
+                HUGE_POOL_BLOCK_SIZE) % (1 << SIZE_CLASS_SHIFT) == 0,
+               "pool block sizes must be multiples of the size-class granularity");
+
+// Filled by build_size_class_table() from whatever sizes the pools were given
+static uint8_t size_class_table[SIZE_CLASS_SLOTS];
+
+// Address range of each pool's block area, filled once all pools are up
+typedef struct {
+    uintptr_t start;
+    uintptr_t end;
+} pool_range_t;
+
+static pool_range_t pool_ranges[POOL_COUNT];
+static uintptr_t pool_range_low = UINTPTR_MAX;   // Envelope for a one-compare heap reject
+static uintptr_t pool_range_high = 0;
+
 // Magic numbers for corruption detection
 #define POOL_MAGIC_FREE    0xDEADBEEF
 #define POOL_MAGIC_ALLOC   0xCAFEBABE
+#define POOL_MAGIC_CACHED  0xCAC4EDB1    // Freed into a per-core magazine
+#define POOL_MAGIC_BAD     0xBAD0B10C    // Corrupt, parked on the quarantine list
+
+// Lock-free head layout: low half is block index + 1, high half an ABA tag
+#define LF_INDEX_MASK      0x0000FFFFu
+#define LF_TAG_STEP        0x00010000u
+
+// Out-of-band payloads are aligned to their own size, up to a cache line
+#define POOL_OOB_MAX_ALIGN 64
+
+static inline memory_block_t* pool_header_at(const memory_pool_t* pool, uint32_t index) {
+    return (memory_block_t*)((uint8_t*)pool->pool_memory + (size_t)index * pool->stride);
+}
+
+static inline block_meta_t* pool_meta_at(const memory_pool_t* pool, uint32_t index) {
+    if (pool->layout == POOL_LAYOUT_OOB) {
+        return &pool->meta_table[index];
+    }
+    return &pool_header_at(pool, index)->meta;
+}
+
+static inline void* pool_payload_at(const memory_pool_t* pool, uint32_t index) {
+    return (uint8_t*)pool->pool_memory + (size_t)index * pool->stride + pool->payload_offset;
+}
+
+// Block index for a payload pointer, -1 if ptr is not the start of a block here
+static inline int32_t pool_block_index(const memory_pool_t* pool, const void* ptr) {
+    uintptr_t base = (uintptr_t)pool->pool_memory + pool->payload_offset;
+    uintptr_t offset = (uintptr_t)ptr - base;
+    
+    if ((uintptr_t)ptr < base || offset >= pool->stride * pool->block_count ||
+        offset % pool->stride != 0) {
+        return -1;
+    }
+    return offset / pool->stride;
+}
+
+// Inline headers repeat pool_id and index; the side table makes both implicit
+static inline bool pool_header_ok(const memory_pool_t* pool, uint32_t index) {
+    if (pool->layout == POOL_LAYOUT_OOB) {
+        return true;
+    }
+    const memory_block_t* header = pool_header_at(pool, index);
+    return header->pool_id == pool->pool_id && header->index == index;
+}
+
+static inline void pool_stamp_header(memory_pool_t* pool, uint32_t index) {
+    if (pool->layout == POOL_LAYOUT_INLINE) {
+        memory_block_t* header = pool_header_at(pool, index);
+        header->pool_id = pool->pool_id;
+        header->index = index;
+        header->alloc_time = esp_timer_get_time();
+    }
+}
+
+static inline void pool_note_alloc(memory_pool_t* pool, uint32_t index) {
+    __atomic_fetch_or(&pool->usage_bitmap[index / 32], 1u << (index % 32), __ATOMIC_RELAXED);
+    
+    size_t used = __atomic_add_fetch(&pool->allocated_blocks, 1, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&pool->peak_usage, __ATOMIC_RELAXED);
+    while (used > peak &&
+           !__atomic_compare_exchange_n(&pool->peak_usage, &peak, used, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    __atomic_fetch_add(&pool->total_allocations, 1, __ATOMIC_RELAXED);
+}
+
+static inline void pool_note_free(memory_pool_t* pool, uint32_t index) {
+    __atomic_fetch_and(&pool->usage_bitmap[index / 32], ~(1u << (index % 32)), __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&pool->allocated_blocks, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&pool->total_deallocations, 1, __ATOMIC_RELAXED);
+}
+
+// Bitmap mode helpers (caller holds the pool mutex)
+static inline uint32_t bitmap_word_count(const memory_pool_t* pool) {
+    return (pool->block_count + 31) / 32;
+}
+
+static inline void bitmap_update_summary(memory_pool_t* pool, uint32_t word) {
+    if (pool->usage_bitmap[word] != UINT32_MAX) {
+        pool->free_summary[word / 32] |= 1u << (word % 32);
+    } else {
+        pool->free_summary[word / 32] &= ~(1u << (word % 32));
+    }
+}
+
+static void bitmap_mark(memory_pool_t* pool, uint32_t first, uint32_t count, bool used) {
+    while (count > 0) {
+        uint32_t word = first / 32;
+        uint32_t bit = first % 32;
+        uint32_t n = (32 - bit < count) ? 32 - bit : count;
+        uint32_t mask = (n == 32) ? UINT32_MAX : ((1u << n) - 1) << bit;
+        
+        if (used) {
+            pool->usage_bitmap[word] |= mask;
+        } else {
+            pool->usage_bitmap[word] &= ~mask;
+        }
+        bitmap_update_summary(pool, word);
+        
+        first += n;
+        count -= n;
+    }
+}
+
+static bool bitmap_all_used(const memory_pool_t* pool, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++) {
+        if (!(pool->usage_bitmap[i / 32] & (1u << (i % 32)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// First index of `count` consecutive free blocks, or -1
+static int32_t bitmap_find_run(const memory_pool_t* pool, uint32_t count) {
+    uint32_t words = bitmap_word_count(pool);
+    
+    if (count == 1) {
+        // Two ctz steps: summary picks the word, the word picks the block
+        for (uint32_t s = 0; s < (words + 31) / 32; s++) {
+            if (pool->free_summary[s]) {
+                uint32_t word = s * 32 + __builtin_ctz(pool->free_summary[s]);
+                return word * 32 + __builtin_ctz(~pool->usage_bitmap[word]);
+            }
+        }
+        return -1;
+    }
+    
+    uint32_t run_start = 0;
+    uint32_t run_len = 0;
+    
+    for (uint32_t w = 0; w < words; w++) {
+        uint32_t free_bits = ~pool->usage_bitmap[w];
+        
+        if (free_bits == 0) {
+            run_len = 0;
+            continue;
+        }
+        
+        if (free_bits == UINT32_MAX) {
+            if (run_len == 0) run_start = w * 32;
+            run_len += 32;
+            if (run_len >= count) return run_start;
+            continue;
+        }
+        
+        // A run carried in from the previous word continues through the low free bits
+        if (run_len > 0 && run_len + __builtin_ctz(~free_bits) >= count) {
+            return run_start;
+        }
+        
+        // Runs inside this word: bit i survives if bits i..i+count-1 are all free
+        if (count <= 32) {
+            uint32_t x = free_bits;
+            uint32_t covered = 1;
+            while (covered < count) {
+                uint32_t step = (covered < count - covered) ? covered : count - covered;
+                x &= x >> step;
+                covered += step;
+            }
+            if (x) return w * 32 + __builtin_ctz(x);
+        }
+        
+        // Free bits at the top may start a run into the next word
+        run_len = __builtin_clz(~free_bits);
+        run_start = (w + 1) * 32 - run_len;
+    }
+    
+    return -1;
+}
+
+// Pop a block index from the lock-free list; the tag makes a stale head fail the CAS
+static int32_t lf_pop(memory_pool_t* pool) {
+    uint32_t old_head = __atomic_load_n(&pool->lf_head, __ATOMIC_ACQUIRE);
+    uint32_t new_head;
+    uint32_t slot;
+    
+    do {
+        slot = old_head & LF_INDEX_MASK;
+        if (slot == 0) {
+            return -1;
+        }
+        uint32_t next = __atomic_load_n(&pool_meta_at(pool, slot - 1)->link, __ATOMIC_RELAXED);
+        new_head = ((old_head & ~LF_INDEX_MASK) + LF_TAG_STEP) | next;
+    } while (!__atomic_compare_exchange_n(&pool->lf_head, &old_head, new_head, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+    
+    return slot - 1;
+}
+
+static void lf_push(memory_pool_t* pool, uint32_t index) {
+    block_meta_t* meta = pool_meta_at(pool, index);
+    uint32_t old_head = __atomic_load_n(&pool->lf_head, __ATOMIC_RELAXED);
+    uint32_t new_head;
+    
+    do {
+        __atomic_store_n(&meta->link, old_head & LF_INDEX_MASK, __ATOMIC_RELAXED);
+        new_head = ((old_head & ~LF_INDEX_MASK) + LF_TAG_STEP) | (index + 1);
+    } while (!__atomic_compare_exchange_n(&pool->lf_head, &old_head, new_head, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static void free_pool_buffers(memory_pool_t* pool) {
+    heap_caps_free(pool->free_summary);
+    heap_caps_free(pool->usage_bitmap);
+    heap_caps_free(pool->meta_table);
+    heap_caps_free(pool->pool_memory);
+}
 
 // Pool management functions
 bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t pool_id) {
     if (!pool || !config) return false;
     
+    if (config->block_count == 0 || config->block_count >= LF_INDEX_MASK) {
+        ESP_LOGE(TAG, "Invalid block count %d for %s pool", config->block_count, config->name);
+        return false;
+    }
+    
     memset(pool, 0, sizeof(memory_pool_t));
     
     pool->name = config->name;
@@ -114,109 +439,246 @@ bool init_memory_pool(memory_pool_t* pool, const pool_config_t* config, uint32_t
     pool->block_count = config->block_count;
     pool->alignment = 4; // 4-byte alignment
     pool->caps = config->caps;
+    pool->mode = config->mode;
+    pool->layout = config->layout;
     pool->pool_id = pool_id;
     
-    // Calculate total memory needed (including headers)
-    size_t header_size = sizeof(memory_block_t);
+    // Calculate total memory needed (inline layout includes headers)
+    if (pool->layout == POOL_LAYOUT_OOB) {
+        pool->alignment = config->block_size & -config->block_size;
+        if (pool->alignment > POOL_OOB_MAX_ALIGN) pool->alignment = POOL_OOB_MAX_ALIGN;
+        if (pool->alignment < 4) pool->alignment = 4;
+        pool->payload_offset = 0;
+    } else {
+        pool->payload_offset = sizeof(memory_block_t);
+    }
     size_t aligned_block_size = (config->block_size + pool->alignment - 1) & 
                                ~(pool->alignment - 1);
-    size_t total_block_size = header_size + aligned_block_size;
-    size_t total_memory = total_block_size * config->block_count;
+    pool->stride = pool->payload_offset + aligned_block_size;
+    size_t total_memory = pool->stride * config->block_count;
     
     // Allocate pool memory
-    pool->pool_memory = heap_caps_malloc(total_memory, config->caps);
-    if (!pool->pool_memory) {
+    if (pool->layout == POOL_LAYOUT_OOB) {
+        pool->pool_memory = heap_caps_aligned_alloc(pool->alignment, total_memory, config->caps);
+        pool->meta_table = heap_caps_calloc(config->block_count, sizeof(block_meta_t),
+                                            MALLOC_CAP_INTERNAL);
+    } else {
+        pool->pool_memory = heap_caps_malloc(total_memory, config->caps);
+    }
+    if (!pool->pool_memory || (pool->layout == POOL_LAYOUT_OOB && !pool->meta_table)) {
+        free_pool_buffers(pool);
         ESP_LOGE(TAG, "Failed to allocate memory for %s pool", config->name);
         return false;
     }
     
-    // Allocate usage bitmap (1 bit per block)
-    size_t bitmap_bytes = (config->block_count + 7) / 8;
-    pool->usage_bitmap = heap_caps_calloc(bitmap_bytes, 1, MALLOC_CAP_INTERNAL);
+    // Allocate usage bitmap (1 bit per block, whole 32-bit words)
+    size_t bitmap_words = (config->block_count + 31) / 32;
+    pool->usage_bitmap = heap_caps_calloc(bitmap_words, sizeof(uint32_t), MALLOC_CAP_INTERNAL);
     if (!pool->usage_bitmap) {
-        heap_caps_free(pool->pool_memory);
+        free_pool_buffers(pool);
         ESP_LOGE(TAG, "Failed to allocate bitmap for %s pool", config->name);
         return false;
     }
     
     // Initialize free list
-    uint8_t* memory_ptr = (uint8_t*)pool->pool_memory;
-    pool->free_list = NULL;
+    pool->free_head = 0;
     
     for (int i = 0; i < config->block_count; i++) {
-        memory_block_t* block = (memory_block_t*)(memory_ptr + (i * total_block_size));
-        block->magic = POOL_MAGIC_FREE;
-        block->pool_id = pool_id;
-        block->alloc_time = 0;
-        block->next = pool->free_list;
-        pool->free_list = block;
+        block_meta_t* meta = pool_meta_at(pool, i);
+        meta->magic = POOL_MAGIC_FREE;
+        meta->link = pool->free_head;
+        pool->free_head = i + 1;
+        
+        if (pool->layout == POOL_LAYOUT_INLINE) {
+            memory_block_t* header = pool_header_at(pool, i);
+            header->pool_id = pool_id;
+            header->index = i;
+            header->alloc_time = 0;
+        }
+    }
+    
+    // Lock-free mode starts from the same chain, tag 0
+    pool->lf_head = pool->free_head;
+    
+    // Bitmap mode: bits past block_count stay "used" so searches never return them
+    if (pool->mode == POOL_MODE_BITMAP) {
+        pool->free_summary = heap_caps_calloc((bitmap_words + 31) / 32, sizeof(uint32_t),
+                                              MALLOC_CAP_INTERNAL);
+        if (!pool->free_summary) {
+            free_pool_buffers(pool);
+            ESP_LOGE(TAG, "Failed to allocate bitmap summary for %s pool", config->name);
+            return false;
+        }
+        
+        if (config->block_count % 32) {
+            pool->usage_bitmap[bitmap_words - 1] = UINT32_MAX << (config->block_count % 32);
+        }
+        for (uint32_t w = 0; w < bitmap_words; w++) {
+            bitmap_update_summary(pool, w);
+        }
     }
     
-    // Create mutex
+    // Create mutex (lock-free pools only use it for statistics snapshots)
     pool->mutex = xSemaphoreCreateMutex();
     if (!pool->mutex) {
-        heap_caps_free(pool->pool_memory);
-        heap_caps_free(pool->usage_bitmap);
+        free_pool_buffers(pool);
         ESP_LOGE(TAG, "Failed to create mutex for %s pool", config->name);
         return false;
     }
     
-    ESP_LOGI(TAG, "✅ Initialized %s pool: %d blocks × %d bytes = %d total bytes",
-             config->name, config->block_count, config->block_size, total_memory);
+    static const char* mode_names[] = {"mutex", "lock-free", "bitmap"};
+    ESP_LOGI(TAG, "✅ Initialized %s pool: %d blocks × %d bytes = %d total bytes (%s, %s headers)",
+             config->name, config->block_count, config->block_size, total_memory,
+             mode_names[pool->mode], pool->layout == POOL_LAYOUT_OOB ? "side-table" : "inline");
     
     return true;
 }
 
+void deinit_memory_pool(memory_pool_t* pool) {
+    if (!pool || !pool->mutex) return;
+    
+    vSemaphoreDelete(pool->mutex);
+    free_pool_buffers(pool);
+    memset(pool, 0, sizeof(memory_pool_t));
+}
+
+// A corrupt block popped off a free list is parked rather than dropped, so
+// the lost capacity shows up in the stats and the integrity check
+static void pool_quarantine(memory_pool_t* pool, uint32_t index) {
+    block_meta_t* meta = pool_meta_at(pool, index);
+    uint32_t old_head = __atomic_load_n(&pool->bad_head, __ATOMIC_RELAXED);
+    
+    ESP_LOGE(TAG, "🚨 Corruption detected in %s pool block %lu (magic 0x%08lX), quarantined",
+             pool->name, index, meta->magic);
+    gpio_set_level(LED_POOL_ERROR, 1);
+    
+    __atomic_store_n(&meta->magic, POOL_MAGIC_BAD, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&meta->link, old_head, __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&pool->bad_head, &old_head, index + 1, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    __atomic_fetch_add(&pool->quarantined, 1, __ATOMIC_RELAXED);
+}
+
+static void* pool_malloc_lockfree(memory_pool_t* pool) {
+    int32_t index = lf_pop(pool);
+    
+    if (index < 0) {
+        __atomic_fetch_add(&pool->allocation_failures, 1, __ATOMIC_RELAXED);
+        ESP_LOGD(TAG, "🔴 %s pool exhausted!", pool->name);
+        gpio_set_level(LED_POOL_FULL, 1);
+        return NULL;
+    }
+    
+    // Check for corruption
+    block_meta_t* meta = pool_meta_at(pool, index);
+    if (meta->magic != POOL_MAGIC_FREE || !pool_header_ok(pool, index)) {
+        pool_quarantine(pool, index);
+        return NULL;
+    }
+    
+    meta->magic = POOL_MAGIC_ALLOC;
+    meta->link = 0;
+    pool_stamp_header(pool, index);
+    pool_note_alloc(pool, index);
+    
+    return pool_payload_at(pool, index);
+}
+
+// Bitmap mode: `count` adjacent blocks as one allocation. The caller gets
+// count * stride - payload_offset usable bytes; inline headers inside the
+// run are overwritten and rebuilt when those blocks are next handed out.
+void* pool_malloc_contiguous(memory_pool_t* pool, size_t count) {
+    if (!pool || !pool->mutex || count == 0 || count > pool->block_count) return NULL;
+    
+    if (pool->mode != POOL_MODE_BITMAP) {
+        ESP_LOGE(TAG, "%s pool: contiguous allocation needs bitmap mode", pool->name);
+        return NULL;
+    }
+    
+    uint64_t start_time = esp_timer_get_time();
+    void* result = NULL;
+    
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        int32_t first = bitmap_find_run(pool, count);
+        
+        if (first >= 0) {
+            bitmap_mark(pool, first, count, true);
+            
+            block_meta_t* meta = pool_meta_at(pool, first);
+            meta->magic = POOL_MAGIC_ALLOC;
+            meta->link = count;
+            pool_stamp_header(pool, first);
+            
+            pool->allocated_blocks += count;
+            if (pool->allocated_blocks > pool->peak_usage) {
+                pool->peak_usage = pool->allocated_blocks;
+            }
+            pool->total_allocations++;
+            
+            result = pool_payload_at(pool, first);
+            
+            ESP_LOGD(TAG, "🟢 %s pool: allocated %d blocks at %p (index %ld)", 
+                     pool->name, count, result, first);
+        } else {
+            pool->allocation_failures++;
+            ESP_LOGW(TAG, "🔴 %s pool: no run of %d free blocks (%d/%d used)", 
+                     pool->name, count, pool->allocated_blocks, pool->block_count);
+            gpio_set_level(LED_POOL_FULL, 1);
+        }
+        
+        xSemaphoreGive(pool->mutex);
+    }
+    
+    pool->allocation_time_total += esp_timer_get_time() - start_time;
+    
+    return result;
+}
+
 void* pool_malloc(memory_pool_t* pool) {
     if (!pool || !pool->mutex) return NULL;
     
     uint64_t start_time = esp_timer_get_time();
     void* result = NULL;
     
+    if (pool->mode == POOL_MODE_BITMAP) {
+        return pool_malloc_contiguous(pool, 1);
+    }
+    
+    if (pool->mode == POOL_MODE_LOCKFREE) {
+        result = pool_malloc_lockfree(pool);
+        __atomic_fetch_add(&pool->allocation_time_total,
+                           esp_timer_get_time() - start_time, __ATOMIC_RELAXED);
+        return result;
+    }
+    
     if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        if (pool->free_list) {
+        if (pool->free_head) {
             // Get block from free list
-            memory_block_t* block = pool->free_list;
-            pool->free_list = block->next;
+            uint32_t index = pool->free_head - 1;
+            block_meta_t* meta = pool_meta_at(pool, index);
+            pool->free_head = meta->link;
             
             // Check for corruption
-            if (block->magic != POOL_MAGIC_FREE || block->pool_id != pool->pool_id) {
-                ESP_LOGE(TAG, "🚨 Corruption detected in %s pool block %p!", 
-                         pool->name, block);
-                gpio_set_level(LED_POOL_ERROR, 1);
+            if (meta->magic != POOL_MAGIC_FREE || !pool_header_ok(pool, index)) {
+                pool_quarantine(pool, index);
                 xSemaphoreGive(pool->mutex);
                 return NULL;
             }
             
             // Mark as allocated
-            block->magic = POOL_MAGIC_ALLOC;
-            block->alloc_time = esp_timer_get_time();
-            block->next = NULL;
-            
-            // Update statistics
-            pool->allocated_blocks++;
-            if (pool->allocated_blocks > pool->peak_usage) {
-                pool->peak_usage = pool->allocated_blocks;
-            }
-            pool->total_allocations++;
+            meta->magic = POOL_MAGIC_ALLOC;
+            meta->link = 0;
+            pool_stamp_header(pool, index);
             
-            // Update bitmap
-            size_t header_size = sizeof(memory_block_t);
-            size_t aligned_block_size = (pool->block_size + pool->alignment - 1) & 
-                                       ~(pool->alignment - 1);
-            size_t total_block_size = header_size + aligned_block_size;
-            size_t block_index = ((uint8_t*)block - (uint8_t*)pool->pool_memory) / 
-                                total_block_size;
-            
-            if (block_index < pool->block_count) {
-                pool->usage_bitmap[block_index / 8] |= (1 << (block_index % 8));
-            }
+            // Update statistics and bitmap
+            pool_note_alloc(pool, index);
             
-            // Return pointer to data area (after header)
-            result = (uint8_t*)block + header_size;
+            // Return pointer to data area
+            result = pool_payload_at(pool, index);
             
-            ESP_LOGD(TAG, "🟢 %s pool: allocated block %p (index %d)", 
-                     pool->name, result, block_index);
+            ESP_LOGD(TAG, "🟢 %s pool: allocated block %p (index %lu)", 
+                     pool->name, result, index);
             
         } else {
             // Pool exhausted
@@ -235,63 +697,149 @@ void* pool_malloc(memory_pool_t* pool) {
     return result;
 }
 
+// Magazine refill: up to n single blocks under one lock acquisition. Coming
+// back short is expected here, so it is neither counted nor reported.
+static uint32_t pool_pop_batch(memory_pool_t* pool, void** out, uint32_t n) {
+    if (!pool || !pool->mutex || pool->mode == POOL_MODE_BITMAP) return 0;
+    
+    uint64_t start_time = esp_timer_get_time();
+    uint32_t got = 0;
+    
+    if (pool->mode == POOL_MODE_LOCKFREE) {
+        while (got < n) {
+            int32_t index = lf_pop(pool);
+            if (index < 0) break;
+            
+            block_meta_t* meta = pool_meta_at(pool, index);
+            if (meta->magic != POOL_MAGIC_FREE || !pool_header_ok(pool, index)) {
+                pool_quarantine(pool, index);
+                break;
+            }
+            
+            meta->magic = POOL_MAGIC_ALLOC;
+            meta->link = 0;
+            pool_stamp_header(pool, index);
+            pool_note_alloc(pool, index);
+            out[got++] = pool_payload_at(pool, index);
+        }
+        
+        __atomic_fetch_add(&pool->allocation_time_total,
+                           esp_timer_get_time() - start_time, __ATOMIC_RELAXED);
+        return got;
+    }
+    
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        while (got < n && pool->free_head) {
+            uint32_t index = pool->free_head - 1;
+            block_meta_t* meta = pool_meta_at(pool, index);
+            pool->free_head = meta->link;
+            
+            if (meta->magic != POOL_MAGIC_FREE || !pool_header_ok(pool, index)) {
+                pool_quarantine(pool, index);
+                break;
+            }
+            
+            meta->magic = POOL_MAGIC_ALLOC;
+            meta->link = 0;
+            pool_stamp_header(pool, index);
+            pool_note_alloc(pool, index);
+            out[got++] = pool_payload_at(pool, index);
+        }
+        
+        xSemaphoreGive(pool->mutex);
+    }
+    
+    pool->allocation_time_total += esp_timer_get_time() - start_time;
+    
+    return got;
+}
+
 bool pool_free(memory_pool_t* pool, void* ptr) {
     if (!pool || !ptr || !pool->mutex) return false;
     
     uint64_t start_time = esp_timer_get_time();
     bool result = false;
     
-    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        // Calculate block address from data pointer
-        size_t header_size = sizeof(memory_block_t);
-        memory_block_t* block = (memory_block_t*)((uint8_t*)ptr - header_size);
+    // Block number from the address; bounds and alignment checked before any metadata read
+    int32_t index = pool_block_index(pool, ptr);
+    if (index < 0) {
+        ESP_LOGE(TAG, "🚨 Block %p out of bounds for %s pool!", ptr, pool->name);
+        gpio_set_level(LED_POOL_ERROR, 1);
+        return false;
+    }
+    block_meta_t* meta = pool_meta_at(pool, index);
+    
+    if (pool->mode == POOL_MODE_LOCKFREE) {
+        // Claim the block by flipping its magic so a racing double free loses
+        uint32_t expected = POOL_MAGIC_ALLOC;
+        if (!pool_header_ok(pool, index) ||
+            !__atomic_compare_exchange_n(&meta->magic, &expected, POOL_MAGIC_FREE, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            ESP_LOGE(TAG, "🚨 Invalid block %p for %s pool! Magic: 0x%08X, Index: %ld",
+                     ptr, pool->name, expected, index);
+            gpio_set_level(LED_POOL_ERROR, 1);
+            return false;
+        }
         
-        // Verify block belongs to this pool
-        if (block->magic != POOL_MAGIC_ALLOC || block->pool_id != pool->pool_id) {
-            ESP_LOGE(TAG, "🚨 Invalid block %p for %s pool! Magic: 0x%08X, Pool ID: %lu",
-                     ptr, pool->name, block->magic, block->pool_id);
+        pool_note_free(pool, index);
+        lf_push(pool, index);
+        __atomic_fetch_add(&pool->deallocation_time_total,
+                           esp_timer_get_time() - start_time, __ATOMIC_RELAXED);
+        return true;
+    }
+    
+    if (pool->mode == POOL_MODE_BITMAP) {
+        if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+            return false;
+        }
+        
+        // The bitmap is authoritative: every block of the span must be marked used
+        uint32_t span = meta->link;
+        if (meta->magic != POOL_MAGIC_ALLOC || !pool_header_ok(pool, index) ||
+            span == 0 || index + span > pool->block_count ||
+            !bitmap_all_used(pool, index, span)) {
+            ESP_LOGE(TAG, "🚨 Invalid block %p for %s pool! Magic: 0x%08X, Index: %ld",
+                     ptr, pool->name, meta->magic, index);
             gpio_set_level(LED_POOL_ERROR, 1);
             xSemaphoreGive(pool->mutex);
             return false;
         }
         
-        // Check if pointer is within pool bounds
-        size_t aligned_block_size = (pool->block_size + pool->alignment - 1) & 
-                                   ~(pool->alignment - 1);
-        size_t total_block_size = header_size + aligned_block_size;
+        bitmap_mark(pool, index, span, false);
+        meta->magic = POOL_MAGIC_FREE;
         
-        if ((uint8_t*)block >= (uint8_t*)pool->pool_memory &&
-            (uint8_t*)block < (uint8_t*)pool->pool_memory + 
-                             (total_block_size * pool->block_count)) {
-            
-            // Calculate block index
-            size_t block_index = ((uint8_t*)block - (uint8_t*)pool->pool_memory) / 
-                                total_block_size;
-            
-            // Clear bitmap
-            if (block_index < pool->block_count) {
-                pool->usage_bitmap[block_index / 8] &= ~(1 << (block_index % 8));
-            }
-            
-            // Mark as free and add to free list  
-            block->magic = POOL_MAGIC_FREE;
-            block->next = pool->free_list;
-            pool->free_list = block;
-            
-            // Update statistics
-            pool->allocated_blocks--;
-            pool->total_deallocations++;
-            
-            ESP_LOGD(TAG, "🟢 %s pool: freed block %p (index %d)", 
-                     pool->name, ptr, block_index);
-            
-            result = true;
-            
-        } else {
-            ESP_LOGE(TAG, "🚨 Block %p out of bounds for %s pool!", ptr, pool->name);
+        pool->allocated_blocks -= span;
+        pool->total_deallocations++;
+        
+        xSemaphoreGive(pool->mutex);
+        
+        pool->deallocation_time_total += esp_timer_get_time() - start_time;
+        return true;
+    }
+    
+    if (xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+        // Verify block belongs to this pool
+        if (meta->magic != POOL_MAGIC_ALLOC || !pool_header_ok(pool, index)) {
+            ESP_LOGE(TAG, "🚨 Invalid block %p for %s pool! Magic: 0x%08X, Index: %ld",
+                     ptr, pool->name, meta->magic, index);
             gpio_set_level(LED_POOL_ERROR, 1);
+            xSemaphoreGive(pool->mutex);
+            return false;
         }
         
+        // Mark as free and add to free list  
+        meta->magic = POOL_MAGIC_FREE;
+        meta->link = pool->free_head;
+        pool->free_head = index + 1;
+        
+        // Update statistics and bitmap
+        pool_note_free(pool, index);
+        
+        ESP_LOGD(TAG, "🟢 %s pool: freed block %p (index %ld)", 
+                 pool->name, ptr, index);
+        
+        result = true;
+        
         xSemaphoreGive(pool->mutex);
     }
     
@@ -301,20 +849,327 @@ bool pool_free(memory_pool_t* pool, void* ptr) {
     return result;
 }
 
-// Smart pool allocator - automatically selects appropriate pool
-void* smart_pool_malloc(size_t size) {
-    // Add small overhead for metadata if needed
-    size_t required_size = size + 16; // Safety margin
+// Activity indicator: allocators post the LED to pulse, the indicator task
+// drains the ring, lights every LED seen, holds for one pulse and clears
+typedef struct {
+    portMUX_TYPE lock;
+    uint8_t events[ACTIVITY_RING_SIZE];    // GPIO numbers
+    uint32_t head;                         // Next write (free-running)
+    uint32_t tail;                         // Next read (free-running)
+    uint32_t posted;
+    uint32_t dropped;                      // Ring full, pulse skipped
+    TaskHandle_t task;
+} activity_ring_t;
+
+static activity_ring_t activity_ring = {
+    .lock = portMUX_INITIALIZER_UNLOCKED
+};
+
+static void activity_post(gpio_num_t led) {
+    bool was_empty;
+    
+    portENTER_CRITICAL(&activity_ring.lock);
+    if (activity_ring.head - activity_ring.tail >= ACTIVITY_RING_SIZE) {
+        activity_ring.dropped++;
+        portEXIT_CRITICAL(&activity_ring.lock);
+        return;
+    }
+    was_empty = (activity_ring.head == activity_ring.tail);
+    activity_ring.events[activity_ring.head % ACTIVITY_RING_SIZE] = (uint8_t)led;
+    activity_ring.head++;
+    activity_ring.posted++;
+    portEXIT_CRITICAL(&activity_ring.lock);
+    
+    // Only the first event of a burst needs to wake the task
+    if (was_empty && activity_ring.task) {
+        xTaskNotifyGive(activity_ring.task);
+    }
+}
+
+void activity_indicator_task(void *pvParameters) {
+    ESP_LOGI(TAG, "💡 Activity indicator started");
+    
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        uint64_t lit = 0;
+        portENTER_CRITICAL(&activity_ring.lock);
+        while (activity_ring.tail != activity_ring.head) {
+            lit |= 1ULL << activity_ring.events[activity_ring.tail % ACTIVITY_RING_SIZE];
+            activity_ring.tail++;
+        }
+        portEXIT_CRITICAL(&activity_ring.lock);
+        
+        for (int pin = 0; pin < 64; pin++) {
+            if (lit & (1ULL << pin)) gpio_set_level((gpio_num_t)pin, 1);
+        }
+        vTaskDelay(pdMS_TO_TICKS(ACTIVITY_PULSE_MS));
+        for (int pin = 0; pin < 64; pin++) {
+            if (lit & (1ULL << pin)) gpio_set_level((gpio_num_t)pin, 0);
+        }
+    }
+}
+
+// Per-core cache layer
+void init_pool_caches(void) {
+    memset(pool_caches, 0, sizeof(pool_caches));
+    
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        for (int i = 0; i < POOL_COUNT; i++) {
+            portMUX_INITIALIZE(&pool_caches[core][i].lock);
+        }
+    }
+}
+
+static inline pool_cache_t* local_pool_cache(int pool_index) {
+    return &pool_caches[xPortGetCoreID()][pool_index];
+}
+
+// Bitmap pools need their free blocks visible for runs, and a small pool
+// would end up parked in one core's magazine, so both bypass the cache
+static inline bool pool_cacheable(const memory_pool_t* pool) {
+    return pool->mode != POOL_MODE_BITMAP && pool->block_count >= POOL_CACHE_MIN_BLOCKS;
+}
+
+// Magazines together never hold more than half of a pool
+static inline uint32_t pool_cache_limit(const memory_pool_t* pool) {
+    uint32_t limit = pool->block_count / (2 * portNUM_PROCESSORS);
+    return limit < POOL_CACHE_MAGAZINE_SIZE ? limit : POOL_CACHE_MAGAZINE_SIZE;
+}
+
+static inline uint32_t pool_cache_batch(const memory_pool_t* pool) {
+    uint32_t limit = pool_cache_limit(pool);
+    return limit < POOL_CACHE_BATCH ? limit : POOL_CACHE_BATCH;
+}
+
+// Magazine blocks carry their own magic, so a second free of one is caught
+static inline bool cache_claim_block(int pool_index, void* ptr) {
+    memory_pool_t* pool = &pools[pool_index];
+    uint32_t expected = POOL_MAGIC_ALLOC;
+    return __atomic_compare_exchange_n(&pool_meta_at(pool, pool_block_index(pool, ptr))->magic,
+                                       &expected, POOL_MAGIC_CACHED, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+}
+
+// Leaving the magazine, for a caller or back to the shared pool
+static inline void cache_release_block(int pool_index, void* ptr) {
+    memory_pool_t* pool = &pools[pool_index];
+    __atomic_store_n(&pool_meta_at(pool, pool_block_index(pool, ptr))->magic,
+                     POOL_MAGIC_ALLOC, __ATOMIC_RELEASE);
+}
+
+// Return one pool's cached blocks to the shared pool (all cores)
+static void drain_pool_cache(int pool_index) {
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        pool_cache_t* cache = &pool_caches[core][pool_index];
+        void* batch[POOL_CACHE_MAGAZINE_SIZE];
+        uint32_t n;
+        
+        portENTER_CRITICAL(&cache->lock);
+        n = cache->count;
+        memcpy(batch, cache->blocks, n * sizeof(void*));
+        cache->count = 0;
+        portEXIT_CRITICAL(&cache->lock);
+        
+        for (uint32_t j = 0; j < n; j++) {
+            cache_release_block(pool_index, batch[j]);
+            pool_free(&pools[pool_index], batch[j]);
+        }
+    }
+}
+
+void drain_pool_caches(void) {
+    for (int i = 0; i < POOL_COUNT; i++) {
+        drain_pool_cache(i);
+    }
+}
+
+static void* cached_pool_malloc(int pool_index) {
+    if (!pool_cacheable(&pools[pool_index])) {
+        return pool_malloc(&pools[pool_index]);
+    }
+    
+    pool_cache_t* cache = local_pool_cache(pool_index);
+    uint32_t limit = pool_cache_limit(&pools[pool_index]);
+    void* ptr = NULL;
+    
+    portENTER_CRITICAL(&cache->lock);
+    if (cache->count > 0) {
+        ptr = cache->blocks[--cache->count];
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+    portEXIT_CRITICAL(&cache->lock);
+    
+    if (ptr) {
+        cache_release_block(pool_index, ptr);
+        return ptr;
+    }
+    
+    // Miss: pull a batch from the shared pool, keep one, stash the rest
+    void* batch[POOL_CACHE_BATCH];
+    uint32_t n = pool_pop_batch(&pools[pool_index], batch, pool_cache_batch(&pools[pool_index]));
+    
+    if (n == 0) {
+        // Shared pool is dry; the other cores' magazines may still hold blocks
+        for (int core = 0; core < portNUM_PROCESSORS && !ptr; core++) {
+            pool_cache_t* other = &pool_caches[core][pool_index];
+            if (other == cache) continue;
+            
+            portENTER_CRITICAL(&other->lock);
+            if (other->count > 0) {
+                ptr = other->blocks[--other->count];
+            }
+            portEXIT_CRITICAL(&other->lock);
+        }
+        if (ptr) {
+            cache_release_block(pool_index, ptr);
+            return ptr;
+        }
+        
+        // Really exhausted: let pool_malloc() count and report it
+        return pool_malloc(&pools[pool_index]);
+    }
+    
+    ptr = batch[--n];
+    for (uint32_t i = 0; i < n; i++) {
+        cache_claim_block(pool_index, batch[i]);
+    }
+    
+    portENTER_CRITICAL(&cache->lock);
+    while (n > 0 && cache->count < limit) {
+        cache->blocks[cache->count++] = batch[--n];
+    }
+    cache->refills++;
+    portEXIT_CRITICAL(&cache->lock);
+    
+    // Another task refilled the magazine meanwhile; give back what did not fit
+    while (n > 0) {
+        cache_release_block(pool_index, batch[--n]);
+        pool_free(&pools[pool_index], batch[n]);
+    }
+    
+    return ptr;
+}
+
+static bool cached_pool_free(int pool_index, void* ptr) {
+    memory_pool_t* pool = &pools[pool_index];
+    int32_t index = pool_block_index(pool, ptr);
+    
+    // Cheap metadata check so a bad or interior pointer never enters the magazine
+    if (index < 0 || pool_meta_at(pool, index)->magic != POOL_MAGIC_ALLOC ||
+        !pool_header_ok(pool, index)) {
+        return pool_free(pool, ptr); // Reports the corruption
+    }
+    
+    if (!pool_cacheable(pool)) {
+        return pool_free(pool, ptr);
+    }
+    
+    // ALLOC -> CACHED; losing means the block was already freed into a magazine
+    if (!cache_claim_block(pool_index, ptr)) {
+        ESP_LOGE(TAG, "🚨 Double free of %p in %s pool cache!", ptr, pool->name);
+        gpio_set_level(LED_POOL_ERROR, 1);
+        return false;
+    }
+    
+    pool_cache_t* cache = local_pool_cache(pool_index);
+    void* batch[POOL_CACHE_BATCH];
+    uint32_t n = 0;
+    
+    portENTER_CRITICAL(&cache->lock);
+    if (cache->count >= pool_cache_limit(pool)) {
+        // Full: move the oldest batch out so the magazine keeps hot blocks
+        n = pool_cache_batch(pool);
+        memcpy(batch, cache->blocks, n * sizeof(void*));
+        memmove(cache->blocks, cache->blocks + n, (cache->count - n) * sizeof(void*));
+        cache->count -= n;
+        cache->flushes++;
+    }
+    cache->blocks[cache->count++] = ptr;
+    portEXIT_CRITICAL(&cache->lock);
+    
+    for (uint32_t i = 0; i < n; i++) {
+        cache_release_block(pool_index, batch[i]);
+        pool_free(&pools[pool_index], batch[i]);
+    }
+    
+    return true;
+}
+
+void build_pool_ranges(void) {
+    pool_range_low = UINTPTR_MAX;
+    pool_range_high = 0;
+    
+    for (int i = 0; i < POOL_COUNT; i++) {
+        pool_ranges[i].start = (uintptr_t)pools[i].pool_memory + pools[i].payload_offset;
+        pool_ranges[i].end = pool_ranges[i].start + pools[i].stride * pools[i].block_count;
+        
+        if (pool_ranges[i].start < pool_range_low) pool_range_low = pool_ranges[i].start;
+        if (pool_ranges[i].end > pool_range_high) pool_range_high = pool_ranges[i].end;
+    }
+}
+
+// Which pool owns ptr, by address alone: never reads memory outside a pool
+static int find_owning_pool(const void* ptr) {
+    uintptr_t addr = (uintptr_t)ptr;
+    
+    if (addr < pool_range_low || addr >= pool_range_high) {
+        return -1;
+    }
     
-    // Find best-fit pool
     for (int i = 0; i < POOL_COUNT; i++) {
-        if (required_size <= pools[i].block_size) {
-            void* ptr = pool_malloc(&pools[i]);
+        if (addr >= pool_ranges[i].start && addr < pool_ranges[i].end) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void build_size_class_table(void) {
+    int pool = 0;
+    
+    for (int slot = 0; slot < SIZE_CLASS_SLOTS; slot++) {
+        while (pool < POOL_COUNT && pools[pool].block_size < ((size_t)slot << SIZE_CLASS_SHIFT)) {
+            pool++;
+        }
+        size_class_table[slot] = pool; // POOL_COUNT: larger than every pool
+    }
+}
+
+// Allocation size profiling: requests per 16-byte slot, sampled by smart_pool_malloc()
+typedef struct {
+    volatile bool enabled;
+    uint32_t slots[SIZE_CLASS_SLOTS];
+    uint32_t oversized;    // Larger than POOL_MAX_BLOCK_SIZE
+    uint32_t samples;
+} pool_profile_t;
+
+static pool_profile_t pool_profile;
+
+static inline void pool_profile_record(size_t size) {
+    if (size > POOL_MAX_BLOCK_SIZE) {
+        __atomic_fetch_add(&pool_profile.oversized, 1, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_add(&pool_profile.slots[SIZE_CLASS_SLOT(size)], 1, __ATOMIC_RELAXED);
+    }
+    __atomic_fetch_add(&pool_profile.samples, 1, __ATOMIC_RELAXED);
+}
+
+// Smart pool allocator - size-class table picks the pool, larger pools
+// only serve as overflow when the preferred one is exhausted
+void* smart_pool_malloc(size_t size) {
+    if (pool_profile.enabled) {
+        pool_profile_record(size);
+    }
+    
+    if (size <= pools[POOL_COUNT - 1].block_size) {
+        for (int i = size_class_table[SIZE_CLASS_SLOT(size)]; i < POOL_COUNT; i++) {
+            void* ptr = cached_pool_malloc(i);
             if (ptr) {
                 // Light up corresponding LED briefly
-                gpio_set_level(pool_configs[i].led_pin, 1);
-                vTaskDelay(pdMS_TO_TICKS(50));
-                gpio_set_level(pool_configs[i].led_pin, 0);
+                activity_post(pool_configs[i].led_pin);
                 
                 ESP_LOGD(TAG, "🎯 Smart allocation: %d bytes from %s pool", 
                          size, pools[i].name);
@@ -323,24 +1178,333 @@ void* smart_pool_malloc(size_t size) {
         }
     }
     
+    // Oversized: a run of adjacent Huge blocks when that pool is in bitmap mode.
+    // A single block was already tried above, so only real runs come here.
+    memory_pool_t* huge = &pools[POOL_HUGE];
+    size_t count = huge->stride ? (size + huge->payload_offset + huge->stride - 1) / huge->stride : 0;
+    if (huge->mode == POOL_MODE_BITMAP && count > 1) {
+        void* ptr = pool_malloc_contiguous(huge, count);
+        if (ptr) {
+            activity_post(pool_configs[POOL_HUGE].led_pin);
+            return ptr;
+        }
+    }
+    
     ESP_LOGW(TAG, "⚠️ No suitable pool for %d bytes, falling back to heap", size);
     return heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
 }
 
-bool smart_pool_free(void* ptr) {
-    if (!ptr) return false;
-    
-    // Try to free from each pool
+bool smart_pool_free(void* ptr) {
+    if (!ptr) return false;
+    
+    int pool_index = find_owning_pool(ptr);
+    if (pool_index >= 0) {
+        return cached_pool_free(pool_index, ptr);
+    }
+    
+    // If not from any pool, try regular heap free
+    ESP_LOGD(TAG, "🎯 Freeing %p from heap (not from pool)", ptr);
+    heap_caps_free(ptr);
+    return true;
+}
+
+// Bytes a pool occupies: payload area plus the side table when out of band
+static size_t pool_footprint(size_t block_size, size_t block_count, pool_layout_t layout) {
+    if (layout == POOL_LAYOUT_OOB) {
+        return (block_size + sizeof(block_meta_t)) * block_count;
+    }
+    return (sizeof(memory_block_t) + ((block_size + 3) & ~3)) * block_count;
+}
+
+// Config blob: fixed-size, versioned, CRC-protected copy of the tunable
+// pool_config_t fields. Names and LED pins stay compile-time.
+#define POOL_CONFIG_BLOB_MAGIC    0x46434C50  // "PLCF"
+#define POOL_CONFIG_BLOB_VERSION  1
+
+typedef struct {
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t caps;
+    uint8_t mode;
+    uint8_t layout;
+    uint16_t reserved;
+} pool_config_entry_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t pool_count;
+    pool_config_entry_t entries[POOL_COUNT];
+    uint32_t crc;          // esp_rom_crc32_le over everything above
+} pool_config_blob_t;
+
+void pack_pool_config_blob(const pool_config_t* configs, pool_config_blob_t* blob) {
+    memset(blob, 0, sizeof(*blob));
+    blob->magic = POOL_CONFIG_BLOB_MAGIC;
+    blob->version = POOL_CONFIG_BLOB_VERSION;
+    blob->pool_count = POOL_COUNT;
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        blob->entries[i].block_size = configs[i].block_size;
+        blob->entries[i].block_count = configs[i].block_count;
+        blob->entries[i].caps = configs[i].caps;
+        blob->entries[i].mode = configs[i].mode;
+        blob->entries[i].layout = configs[i].layout;
+    }
+
+    blob->crc = esp_rom_crc32_le(0, (const uint8_t*)blob, offsetof(pool_config_blob_t, crc));
+}
+
+// Validate a blob and copy it over pool_configs; must run before the pools exist
+bool apply_pool_config_blob(const void* data, size_t length) {
+    const pool_config_blob_t* blob = data;
+
+    if (pools_initialized) {
+        ESP_LOGE(TAG, "Pool config blob must be applied before pool init");
+        return false;
+    }
+
+    if (!blob || length != sizeof(pool_config_blob_t) ||
+        blob->magic != POOL_CONFIG_BLOB_MAGIC || blob->version != POOL_CONFIG_BLOB_VERSION ||
+        blob->pool_count != POOL_COUNT) {
+        ESP_LOGW(TAG, "⚠️ Pool config blob rejected: bad header or size (%d bytes)", length);
+        return false;
+    }
+
+    if (blob->crc != esp_rom_crc32_le(0, (const uint8_t*)blob, offsetof(pool_config_blob_t, crc))) {
+        ESP_LOGW(TAG, "⚠️ Pool config blob rejected: CRC mismatch");
+        return false;
+    }
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        const pool_config_entry_t* e = &blob->entries[i];
+        uint32_t prev_size = (i > 0) ? blob->entries[i - 1].block_size : 0;
+
+        if (e->block_size <= prev_size || e->block_size > POOL_MAX_BLOCK_SIZE ||
+            e->block_size % (1 << SIZE_CLASS_SHIFT) != 0 ||
+            e->block_count == 0 || e->block_count >= LF_INDEX_MASK ||
+            e->mode > POOL_MODE_BITMAP || e->layout > POOL_LAYOUT_OOB) {
+            ESP_LOGW(TAG, "⚠️ Pool config blob rejected: bad entry %d (%lu × %lu)",
+                     i, e->block_count, e->block_size);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        pool_configs[i].block_size = blob->entries[i].block_size;
+        pool_configs[i].block_count = blob->entries[i].block_count;
+        pool_configs[i].caps = blob->entries[i].caps;
+        pool_configs[i].mode = blob->entries[i].mode;
+        pool_configs[i].layout = blob->entries[i].layout;
+    }
+
+    ESP_LOGI(TAG, "📥 Pool config blob applied");
+    return true;
+}
+
+static void init_pool_config_storage(void) {
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+}
+
+// Use a stored config blob if there is one, else keep the compile-time defaults
+bool load_pool_config_from_nvs(void) {
+    nvs_handle_t handle;
+    pool_config_blob_t blob;
+    size_t length = sizeof(blob);
+
+    if (nvs_open(POOL_CONFIG_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    esp_err_t ret = nvs_get_blob(handle, POOL_CONFIG_NVS_KEY, &blob, &length);
+    nvs_close(handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGI(TAG, "No stored pool config, using compile-time defaults");
+        return false;
+    }
+    return apply_pool_config_blob(&blob, length);
+}
+
+bool save_pool_config_to_nvs(const pool_config_blob_t* blob) {
+    nvs_handle_t handle;
+
+    if (nvs_open(POOL_CONFIG_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return false;
+    }
+    esp_err_t ret = nvs_set_blob(handle, POOL_CONFIG_NVS_KEY, blob, sizeof(*blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store pool config: %s", esp_err_to_name(ret));
+        return false;
+    }
+    ESP_LOGI(TAG, "💾 Pool config stored, applied on next boot");
+    return true;
+}
+
+void pool_profile_start(void) {
+    memset(pool_profile.slots, 0, sizeof(pool_profile.slots));
+    pool_profile.oversized = 0;
+    pool_profile.samples = 0;
+    pool_profile.enabled = true;
+}
+
+void pool_profile_stop(void) {
+    pool_profile.enabled = false;
+}
+
+// Internal fragmentation of the profiled requests under a set of block
+// sizes, in bytes, counting each request at its 16-byte slot size
+static uint64_t profile_waste(const size_t* block_sizes) {
+    uint64_t waste = 0;
+    int pool = 0;
+
+    for (int slot = 1; slot < SIZE_CLASS_SLOTS; slot++) {
+        uint32_t n = pool_profile.slots[slot] + (slot == 1 ? pool_profile.slots[0] : 0);
+        size_t size = (size_t)slot << SIZE_CLASS_SHIFT;
+
+        while (pool < POOL_COUNT && block_sizes[pool] < size) pool++;
+        if (pool == POOL_COUNT) break;
+        waste += (uint64_t)n * (block_sizes[pool] - size);
+    }
+    return waste;
+}
+
+// Pick POOL_COUNT block sizes minimizing internal fragmentation over the
+// histogram (DP over slot boundaries), then split ram_budget between the
+// classes in proportion to how often each was requested. Modes, layouts
+// and caps are carried over from the current table position by position.
+bool recommend_pool_configs(size_t ram_budget, pool_config_t* out) {
+    int last = 0;
+    for (int slot = 0; slot < SIZE_CLASS_SLOTS; slot++) {
+        if (pool_profile.slots[slot]) last = slot;
+    }
+    if (pool_profile.samples == 0 || (last == 0 && pool_profile.slots[0] == 0)) {
+        ESP_LOGW(TAG, "⚠️ No profiled allocations to size pools from");
+        return false;
+    }
+    if (last < POOL_COUNT) last = POOL_COUNT;
+
+    // Prefix sums over slots 1..last (size-0 requests count as slot 1)
+    uint64_t* count_sum = calloc(last + 1, sizeof(uint64_t));
+    uint64_t* weight_sum = calloc(last + 1, sizeof(uint64_t));
+    uint64_t* cost = malloc((last + 1) * sizeof(uint64_t) * 2);
+    uint16_t* cut = malloc((last + 1) * POOL_COUNT * sizeof(uint16_t));
+    if (!count_sum || !weight_sum || !cost || !cut) {
+        free(count_sum); free(weight_sum); free(cost); free(cut);
+        return false;
+    }
+
+    for (int slot = 1; slot <= last; slot++) {
+        uint64_t n = pool_profile.slots[slot] + (slot == 1 ? pool_profile.slots[0] : 0);
+        count_sum[slot] = count_sum[slot - 1] + n;
+        weight_sum[slot] = weight_sum[slot - 1] + n * slot;
+    }
+
+    // Waste (in slots) when slots j..i all go to a class of size i
+    #define CLASS_WASTE(j, i) ((i) * (count_sum[i] - count_sum[(j) - 1]) - \
+                               (weight_sum[i] - weight_sum[(j) - 1]))
+
+    uint64_t* prev = cost;
+    uint64_t* cur = cost + last + 1;
+    for (int i = 1; i <= last; i++) {
+        prev[i] = CLASS_WASTE(1, i);
+        cut[i * POOL_COUNT] = 1;
+    }
+    for (int k = 1; k < POOL_COUNT; k++) {
+        for (int i = k + 1; i <= last; i++) {
+            cur[i] = UINT64_MAX;
+            for (int j = k + 1; j <= i; j++) {
+                uint64_t c = prev[j - 1] + CLASS_WASTE(j, i);
+                if (c < cur[i]) {
+                    cur[i] = c;
+                    cut[i * POOL_COUNT + k] = j;
+                }
+            }
+        }
+        uint64_t* t = prev; prev = cur; cur = t;
+    }
+    #undef CLASS_WASTE
+
+    // Walk the cuts back from the largest class
+    uint32_t requests[POOL_COUNT];
+    int end = last;
+    for (int k = POOL_COUNT - 1; k >= 0; k--) {
+        int start = cut[end * POOL_COUNT + k];
+        out[k] = pool_configs[k];
+        out[k].block_size = (size_t)end << SIZE_CLASS_SHIFT;
+        requests[k] = count_sum[end] - count_sum[start - 1];
+        end = start - 1;
+    }
+
+    free(count_sum); free(weight_sum); free(cost); free(cut);
+
+    // Every class keeps at least one block; the rest of the budget follows demand
+    size_t reserved = 0;
+    uint64_t demand = 0;
+    for (int k = 0; k < POOL_COUNT; k++) {
+        size_t one = pool_footprint(out[k].block_size, 1, out[k].layout);
+        reserved += one;
+        demand += (uint64_t)requests[k] * one;
+    }
+    size_t spare = (ram_budget > reserved) ? ram_budget - reserved : 0;
+
+    // Blocks in proportion to requests: sum of count * footprint stays within spare
+    for (int k = 0; k < POOL_COUNT; k++) {
+        size_t extra = demand ? (size_t)((uint64_t)spare * requests[k] / demand) : 0;
+        out[k].block_count = 1 + extra;
+        if (out[k].block_count >= LF_INDEX_MASK) out[k].block_count = LF_INDEX_MASK - 1;
+    }
+
+    return true;
+}
+
+// Print the histogram summary and a recommended table in pool_configs[] form
+void pool_profile_report(size_t ram_budget) {
+    pool_config_t recommended[POOL_COUNT];
+    size_t current_sizes[POOL_COUNT];
+    size_t new_sizes[POOL_COUNT];
+
+    ESP_LOGI(TAG, "\n🔬 ═══ ALLOCATION SIZE PROFILE ═══");
+    ESP_LOGI(TAG, "Samples: %lu (oversized: %lu)", pool_profile.samples, pool_profile.oversized);
+
+    if (!recommend_pool_configs(ram_budget, recommended)) {
+        return;
+    }
+
+    for (int i = 0; i < POOL_COUNT; i++) {
+        current_sizes[i] = pools[i].block_size;
+        new_sizes[i] = recommended[i].block_size;
+    }
+
+    static const char* mode_names[] = {"POOL_MODE_MUTEX", "POOL_MODE_LOCKFREE", "POOL_MODE_BITMAP"};
+    static const char* layout_names[] = {"POOL_LAYOUT_INLINE", "POOL_LAYOUT_OOB"};
+
+    ESP_LOGI(TAG, "Internal fragmentation: current %llu bytes, recommended %llu bytes",
+             profile_waste(current_sizes), profile_waste(new_sizes));
+    ESP_LOGI(TAG, "Recommended pool_configs (budget %d bytes):", ram_budget);
     for (int i = 0; i < POOL_COUNT; i++) {
-        if (pool_free(&pools[i], ptr)) {
-            return true;
-        }
+        ESP_LOGI(TAG, "    {\"%s\", %d, %d, 0x%08lX, GPIO%d, %s, %s},",
+                 recommended[i].name, recommended[i].block_size, recommended[i].block_count,
+                 recommended[i].caps, recommended[i].led_pin,
+                 mode_names[recommended[i].mode], layout_names[recommended[i].layout]);
     }
-    
-    // If not from any pool, try regular heap free
-    ESP_LOGD(TAG, "🎯 Freeing %p from heap (not from pool)", ptr);
-    heap_caps_free(ptr);
-    return true;
+
+#if POOL_PROFILE_SAVE
+    pool_config_blob_t blob;
+    pack_pool_config_blob(recommended, &blob);
+    save_pool_config_to_nvs(&blob);
+#endif
+
+    ESP_LOGI(TAG, "═══════════════════════════════════════");
 }
 
 // Pool statistics and monitoring
@@ -361,6 +1525,9 @@ void print_pool_statistics(void) {
             ESP_LOGI(TAG, "  Allocations:     %llu", pool->total_allocations);
             ESP_LOGI(TAG, "  Deallocations:   %llu", pool->total_deallocations);
             ESP_LOGI(TAG, "  Failures:        %lu", pool->allocation_failures);
+            if (pool->quarantined > 0) {
+                ESP_LOGW(TAG, "  Quarantined:     %lu blocks", pool->quarantined);
+            }
             
             if (pool->total_allocations > 0) {
                 uint32_t avg_alloc_time = pool->allocation_time_total / pool->total_allocations;
@@ -374,6 +1541,20 @@ void print_pool_statistics(void) {
             
             xSemaphoreGive(pool->mutex);
         }
+        
+        // Per-core cache: refills/flushes are the only trips to the shared pool
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            pool_cache_t* cache = &pool_caches[core][i];
+            uint32_t lookups = cache->hits + cache->misses;
+            
+            if (lookups > 0 || cache->flushes > 0) {
+                ESP_LOGI(TAG, "  Core %d Cache:    %lu cached, %lu hits / %lu misses (%lu%% hit), "
+                         "%lu refills, %lu flushes",
+                         core, cache->count, cache->hits, cache->misses,
+                         lookups ? (cache->hits * 100) / lookups : 0,
+                         cache->refills, cache->flushes);
+            }
+        }
     }
     
     ESP_LOGI(TAG, "═══════════════════════════════════════");
@@ -417,21 +1598,80 @@ bool check_pool_integrity(void) {
         memory_pool_t* pool = &pools[i];
         bool pool_ok = true;
         
-        if (pool->mutex && xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+        if (pool->mutex && pool->mode == POOL_MODE_LOCKFREE) {
+            // The lock-free list moves underneath us, so sweep headers by slot instead
+            int free_count = 0;
+            
+            for (uint32_t b = 0; b < pool->block_count; b++) {
+                uint32_t magic = __atomic_load_n(&pool_meta_at(pool, b)->magic, __ATOMIC_RELAXED);
+                if (magic == POOL_MAGIC_BAD) {
+                    continue;   // Already reported and out of service
+                }
+                
+                if ((magic != POOL_MAGIC_FREE && magic != POOL_MAGIC_ALLOC &&
+                     magic != POOL_MAGIC_CACHED) ||
+                    !pool_header_ok(pool, b)) {
+                    ESP_LOGE(TAG, "❌ %s pool: Corrupted block %lu", pool->name, b);
+                    pool_ok = false;
+                    break;
+                }
+                
+                if (magic == POOL_MAGIC_FREE) {
+                    free_count++;
+                }
+            }
+            
+            if (pool_ok) {
+                ESP_LOGI(TAG, "✅ %s pool: %d free blocks verified, %lu quarantined", 
+                         pool->name, free_count, pool->quarantined);
+            }
+        } else if (pool->mutex && pool->mode == POOL_MODE_BITMAP &&
+                   xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+            // Bitmap and summary only; block memory (SPIRAM) is never touched
+            uint32_t words = bitmap_word_count(pool);
+            uint32_t used = 0;
+
+            for (uint32_t w = 0; w < words; w++) {
+                bool has_free = pool->usage_bitmap[w] != UINT32_MAX;
+                bool summary = pool->free_summary[w / 32] & (1u << (w % 32));
+                if (has_free != summary) {
+                    ESP_LOGE(TAG, "❌ %s pool: Summary disagrees with bitmap word %lu",
+                             pool->name, w);
+                    pool_ok = false;
+                    break;
+                }
+                used += __builtin_popcount(pool->usage_bitmap[w]);
+            }
+
+            uint32_t padding = words * 32 - pool->block_count;
+            if (pool_ok && used - padding != pool->allocated_blocks) {
+                ESP_LOGE(TAG, "❌ %s pool: Bitmap shows %lu used, counter says %d",
+                         pool->name, used - padding, pool->allocated_blocks);
+                pool_ok = false;
+            }
+
+            if (pool_ok) {
+                ESP_LOGI(TAG, "✅ %s pool: %d free blocks verified (bitmap)",
+                         pool->name, pool->block_count - pool->allocated_blocks);
+            }
+
+            xSemaphoreGive(pool->mutex);
+        } else if (pool->mutex && xSemaphoreTake(pool->mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
             // Check free list
-            memory_block_t* current = pool->free_list;
+            uint32_t slot = pool->free_head;
             int free_count = 0;
             
-            while (current && free_count < pool->block_count) {
-                if (current->magic != POOL_MAGIC_FREE || 
-                    current->pool_id != pool->pool_id) {
-                    ESP_LOGE(TAG, "❌ %s pool: Corrupted free block %p", 
-                             pool->name, current);
+            while (slot && free_count < pool->block_count) {
+                if (slot > pool->block_count ||
+                    pool_meta_at(pool, slot - 1)->magic != POOL_MAGIC_FREE || 
+                    !pool_header_ok(pool, slot - 1)) {
+                    ESP_LOGE(TAG, "❌ %s pool: Corrupted free block %lu", 
+                             pool->name, slot - 1);
                     pool_ok = false;
                     break;
                 }
                 
-                current = current->next;
+                slot = pool_meta_at(pool, slot - 1)->link;
                 free_count++;
             }
             
@@ -682,6 +1922,471 @@ void pool_pattern_test_task(void *pvParameters) {
     }
 }
 
+// Contention benchmark: several producers hammer one pool, mutex vs lock-free
+typedef struct {
+    memory_pool_t* pool;
+    uint32_t* latencies;        // One sample per free+alloc pair, in μs
+    SemaphoreHandle_t start;
+    SemaphoreHandle_t done;
+} contention_worker_t;
+
+static void contention_worker_task(void *pvParameters) {
+    contention_worker_t* worker = (contention_worker_t*)pvParameters;
+    void* held[CONTENTION_BENCH_HELD] = {NULL};
+    
+    xSemaphoreTake(worker->start, portMAX_DELAY);
+    
+    for (int i = 0; i < CONTENTION_BENCH_PAIRS; i++) {
+        int slot = i % CONTENTION_BENCH_HELD;
+        uint64_t t0 = esp_timer_get_time();
+        
+        if (held[slot]) {
+            pool_free(worker->pool, held[slot]);
+        }
+        held[slot] = pool_malloc(worker->pool);
+        
+        worker->latencies[i] = (uint32_t)(esp_timer_get_time() - t0);
+    }
+    
+    for (int i = 0; i < CONTENTION_BENCH_HELD; i++) {
+        if (held[i]) {
+            pool_free(worker->pool, held[i]);
+        }
+    }
+    
+    xSemaphoreGive(worker->done);
+    vTaskDelete(NULL);
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void run_contention_benchmark(pool_mode_t mode) {
+    const pool_config_t bench_config = {
+        "Bench", SMALL_POOL_BLOCK_SIZE, CONTENTION_BENCH_WORKERS * CONTENTION_BENCH_HELD,
+        MALLOC_CAP_INTERNAL, LED_SMALL_POOL, mode
+    };
+    const size_t total_pairs = CONTENTION_BENCH_WORKERS * CONTENTION_BENCH_PAIRS;
+    const char* mode_name = (mode == POOL_MODE_LOCKFREE) ? "Lock-free" : "Mutex";
+    
+    memory_pool_t bench_pool;
+    contention_worker_t workers[CONTENTION_BENCH_WORKERS];
+    uint32_t* latencies = heap_caps_malloc(total_pairs * sizeof(uint32_t), MALLOC_CAP_DEFAULT);
+    SemaphoreHandle_t start = xSemaphoreCreateCounting(CONTENTION_BENCH_WORKERS, 0);
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(CONTENTION_BENCH_WORKERS, 0);
+    
+    if (!latencies || !start || !done || !init_memory_pool(&bench_pool, &bench_config, 0xBE)) {
+        ESP_LOGE(TAG, "Failed to set up %s contention benchmark", mode_name);
+        if (latencies) heap_caps_free(latencies);
+        if (start) vSemaphoreDelete(start);
+        if (done) vSemaphoreDelete(done);
+        return;
+    }
+    
+    for (int i = 0; i < CONTENTION_BENCH_WORKERS; i++) {
+        workers[i].pool = &bench_pool;
+        workers[i].latencies = latencies + i * CONTENTION_BENCH_PAIRS;
+        workers[i].start = start;
+        workers[i].done = done;
+        xTaskCreatePinnedToCore(contention_worker_task, "BenchWorker", 2048, &workers[i], 5,
+                                NULL, i % portNUM_PROCESSORS);
+    }
+    
+    // Release all producers at once and time until the last one finishes
+    uint64_t start_time = esp_timer_get_time();
+    for (int i = 0; i < CONTENTION_BENCH_WORKERS; i++) {
+        xSemaphoreGive(start);
+    }
+    for (int i = 0; i < CONTENTION_BENCH_WORKERS; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    uint64_t elapsed = esp_timer_get_time() - start_time;
+    
+    qsort(latencies, total_pairs, sizeof(uint32_t), compare_u32);
+    
+    float ops_per_sec = elapsed ? (total_pairs * 2.0f * 1000000.0f) / elapsed : 0.0f;
+    ESP_LOGI(TAG, "%-9s: %d workers, %.0f ops/s, pair latency p50=%lu μs p99=%lu μs max=%lu μs",
+             mode_name, CONTENTION_BENCH_WORKERS, ops_per_sec,
+             latencies[total_pairs / 2], latencies[(total_pairs * 99) / 100],
+             latencies[total_pairs - 1]);
+    
+    deinit_memory_pool(&bench_pool);
+    heap_caps_free(latencies);
+    vSemaphoreDelete(start);
+    vSemaphoreDelete(done);
+}
+
+// Per-call smart_pool_malloc latency with activity LEDs enabled
+void run_alloc_latency_benchmark(void) {
+    const size_t test_sizes[] = {32, 128, 512, 2048};
+    const int num_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    uint32_t* latencies = heap_caps_malloc(LATENCY_BENCH_SAMPLES * sizeof(uint32_t),
+                                           MALLOC_CAP_DEFAULT);
+    
+    if (!latencies) {
+        ESP_LOGE(TAG, "Failed to set up latency benchmark");
+        return;
+    }
+    
+    for (int i = 0; i < LATENCY_BENCH_SAMPLES; i++) {
+        size_t size = test_sizes[i % num_sizes];
+        
+        uint64_t t0 = esp_timer_get_time();
+        void* ptr = smart_pool_malloc(size);
+        latencies[i] = (uint32_t)(esp_timer_get_time() - t0);
+        
+        smart_pool_free(ptr);
+    }
+    
+    qsort(latencies, LATENCY_BENCH_SAMPLES, sizeof(uint32_t), compare_u32);
+    
+    ESP_LOGI(TAG, "smart_pool_malloc: %d calls, p50=%lu μs p99=%lu μs max=%lu μs "
+             "(LED events posted %lu, dropped %lu)",
+             LATENCY_BENCH_SAMPLES, latencies[LATENCY_BENCH_SAMPLES / 2],
+             latencies[(LATENCY_BENCH_SAMPLES * 99) / 100],
+             latencies[LATENCY_BENCH_SAMPLES - 1],
+             activity_ring.posted, activity_ring.dropped);
+    
+    heap_caps_free(latencies);
+}
+
+// Zero-copy packet buffers: fixed blocks from a dedicated lock-free pool,
+// reference counted, with headroom for prepending headers and chaining for
+// scatter-gather. Queues carry packet_buffer_t pointers, never packet bytes.
+typedef struct packet_buffer {
+    struct packet_buffer* next;    // Next segment of a chain (owned reference)
+    uint8_t* data;                 // First valid byte in buf[]
+    uint16_t length;               // Valid bytes in this segment
+    uint16_t capacity;             // Size of buf[]
+    uint32_t refcount;
+    uint64_t timestamp;
+    uint8_t buf[];                 // Headroom | data | tailroom
+} packet_buffer_t;
+
+#define PACKET_BLOCK_SIZE  (((sizeof(packet_buffer_t) + PACKET_HEADROOM + PACKET_BUFFER_SIZE) + 15) & ~15)
+
+static memory_pool_t packet_pool;
+static uint32_t packet_alloc_failures = 0;
+
+bool packet_pool_init(void) {
+    const pool_config_t packet_config = {
+        "Packet", PACKET_BLOCK_SIZE, PACKET_BUFFER_COUNT, MALLOC_CAP_INTERNAL,
+        LED_MEDIUM_POOL, POOL_MODE_LOCKFREE, POOL_LAYOUT_OOB
+    };
+    return init_memory_pool(&packet_pool, &packet_config, 0x50);
+}
+
+// New single-segment packet of `length` bytes with PACKET_HEADROOM in front
+packet_buffer_t* packet_alloc(size_t length) {
+    size_t capacity = PACKET_BLOCK_SIZE - sizeof(packet_buffer_t);
+    
+    if (length > capacity - PACKET_HEADROOM) {
+        ESP_LOGE(TAG, "Packet of %d bytes exceeds buffer size", length);
+        return NULL;
+    }
+    
+    packet_buffer_t* pkt = pool_malloc(&packet_pool);
+    if (!pkt) {
+        __atomic_fetch_add(&packet_alloc_failures, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    
+    pkt->next = NULL;
+    pkt->capacity = capacity;
+    pkt->data = pkt->buf + PACKET_HEADROOM;
+    pkt->length = length;
+    pkt->refcount = 1;
+    pkt->timestamp = esp_timer_get_time();
+    return pkt;
+}
+
+static inline size_t packet_headroom(const packet_buffer_t* pkt) {
+    return pkt->data - pkt->buf;
+}
+
+static inline size_t packet_tailroom(const packet_buffer_t* pkt) {
+    return pkt->capacity - packet_headroom(pkt) - pkt->length;
+}
+
+// Prepend n bytes in place; returns the new header start or NULL if no headroom
+uint8_t* packet_push_header(packet_buffer_t* pkt, size_t n) {
+    if (packet_headroom(pkt) < n) return NULL;
+    pkt->data -= n;
+    pkt->length += n;
+    return pkt->data;
+}
+
+// Strip n bytes from the front; returns the new data start
+uint8_t* packet_pull_header(packet_buffer_t* pkt, size_t n) {
+    if (pkt->length < n) return NULL;
+    pkt->data += n;
+    pkt->length -= n;
+    return pkt->data;
+}
+
+// Append n bytes in the tailroom; returns where the caller writes them
+uint8_t* packet_put(packet_buffer_t* pkt, size_t n) {
+    if (packet_tailroom(pkt) < n) return NULL;
+    uint8_t* tail = pkt->data + pkt->length;
+    pkt->length += n;
+    return tail;
+}
+
+void packet_ref(packet_buffer_t* pkt) {
+    __atomic_fetch_add(&pkt->refcount, 1, __ATOMIC_RELAXED);
+}
+
+// Drop one reference; a segment that reaches zero is freed together with
+// the reference it held on the rest of the chain
+void packet_unref(packet_buffer_t* pkt) {
+    while (pkt) {
+        if (__atomic_sub_fetch(&pkt->refcount, 1, __ATOMIC_ACQ_REL) != 0) {
+            return;
+        }
+        packet_buffer_t* next = pkt->next;
+        pool_free(&packet_pool, pkt);
+        pkt = next;
+    }
+}
+
+// Append tail to head's chain; head takes over the caller's reference to tail
+void packet_chain(packet_buffer_t* head, packet_buffer_t* tail) {
+    while (head->next) {
+        head = head->next;
+    }
+    head->next = tail;
+}
+
+size_t packet_total_length(const packet_buffer_t* pkt) {
+    size_t total = 0;
+    for (; pkt; pkt = pkt->next) {
+        total += pkt->length;
+    }
+    return total;
+}
+
+// Queue handoff by pointer: the queue item is sizeof(packet_buffer_t*)
+static inline QueueHandle_t packet_queue_create(UBaseType_t depth) {
+    return xQueueCreate(depth, sizeof(packet_buffer_t*));
+}
+
+bool packet_send(QueueHandle_t queue, packet_buffer_t* pkt, TickType_t wait) {
+    return xQueueSend(queue, &pkt, wait) == pdTRUE;
+}
+
+packet_buffer_t* packet_receive(QueueHandle_t queue, TickType_t wait) {
+    packet_buffer_t* pkt = NULL;
+    if (xQueueReceive(queue, &pkt, wait) != pdTRUE) {
+        return NULL;
+    }
+    return pkt;
+}
+
+// Legacy by-value packet, kept as the copy baseline for the benchmark
+typedef struct {
+    uint8_t data[PACKET_BUFFER_SIZE];
+    size_t length;
+    uint64_t timestamp;
+} network_packet_t;
+
+typedef struct {
+    uint8_t type;
+    uint8_t flags;
+    uint16_t length;
+} packet_header_t;
+
+// Pipeline: producer -> framer (prepends header, chains trailer) -> consumer
+static QueueHandle_t packet_raw_queue;
+static QueueHandle_t packet_framed_queue;
+
+static void packet_producer_task(void *pvParameters) {
+    uint32_t seq = 0;
+    
+    while (1) {
+        size_t length = 64 + esp_random() % (PACKET_BUFFER_SIZE - 64);
+        packet_buffer_t* pkt = packet_alloc(length);
+        if (!pkt) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        
+        memset(pkt->data, (uint8_t)seq, pkt->length);
+        memcpy(pkt->data, &seq, sizeof(seq));
+        seq++;
+        
+        if (!packet_send(packet_raw_queue, pkt, pdMS_TO_TICKS(100))) {
+            packet_unref(pkt);
+        }
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
+}
+
+static void packet_framer_task(void *pvParameters) {
+    while (1) {
+        packet_buffer_t* pkt = packet_receive(packet_raw_queue, portMAX_DELAY);
+        if (!pkt) continue;
+        
+        // Header goes into headroom: no copy of the payload
+        packet_header_t header = {
+            .type = 0x01, .flags = 0, .length = (uint16_t)pkt->length
+        };
+        uint8_t* hdr = packet_push_header(pkt, sizeof(header));
+        if (hdr) {
+            memcpy(hdr, &header, sizeof(header));
+        }
+        
+        // Trailer in a second segment (scatter-gather)
+        packet_buffer_t* trailer = packet_alloc(sizeof(uint32_t));
+        if (trailer) {
+            uint32_t stamp = (uint32_t)(esp_timer_get_time() - pkt->timestamp);
+            memcpy(trailer->data, &stamp, sizeof(stamp));
+            packet_chain(pkt, trailer);
+        }
+        
+        if (!packet_send(packet_framed_queue, pkt, pdMS_TO_TICKS(100))) {
+            packet_unref(pkt);
+        }
+    }
+}
+
+static void packet_consumer_task(void *pvParameters) {
+    uint32_t received = 0;
+    uint64_t bytes = 0;
+    
+    while (1) {
+        packet_buffer_t* pkt = packet_receive(packet_framed_queue, portMAX_DELAY);
+        if (!pkt) continue;
+        
+        // Checksum walks the segments in place
+        uint32_t sum = 0;
+        for (packet_buffer_t* seg = pkt; seg; seg = seg->next) {
+            for (uint16_t i = 0; i < seg->length; i++) {
+                sum += seg->data[i];
+            }
+        }
+        
+        received++;
+        bytes += packet_total_length(pkt);
+        packet_unref(pkt);
+        
+        if (received % 100 == 0) {
+            ESP_LOGI(TAG, "📦 Packets: %lu received, %llu bytes, last checksum 0x%08lX, "
+                     "%d/%d buffers in use, %lu alloc failures",
+                     received, bytes, sum, packet_pool.allocated_blocks,
+                     packet_pool.block_count, packet_alloc_failures);
+        }
+    }
+}
+
+// Queue handoff cost: whole network_packet_t copies vs packet pointers
+void run_packet_handoff_benchmark(void) {
+    QueueHandle_t copy_queue = xQueueCreate(1, sizeof(network_packet_t));
+    QueueHandle_t ptr_queue = packet_queue_create(1);
+    network_packet_t* staging = heap_caps_malloc(2 * sizeof(network_packet_t), MALLOC_CAP_DEFAULT);
+    packet_buffer_t* pkt = packet_alloc(PACKET_BUFFER_SIZE);
+    
+    if (!copy_queue || !ptr_queue || !staging || !pkt) {
+        ESP_LOGE(TAG, "Packet benchmark setup failed");
+    } else {
+        staging[0].length = PACKET_BUFFER_SIZE;
+        
+        uint64_t start = esp_timer_get_time();
+        for (int i = 0; i < PACKET_BENCH_PACKETS; i++) {
+            xQueueSend(copy_queue, &staging[0], 0);
+            xQueueReceive(copy_queue, &staging[1], 0);
+        }
+        uint64_t copy_time = esp_timer_get_time() - start;
+        
+        start = esp_timer_get_time();
+        for (int i = 0; i < PACKET_BENCH_PACKETS; i++) {
+            packet_send(ptr_queue, pkt, 0);
+            pkt = packet_receive(ptr_queue, 0);
+        }
+        uint64_t ptr_time = esp_timer_get_time() - start;
+        
+        ESP_LOGI(TAG, "📦 Queue handoff, %d packets of %d bytes:",
+                 PACKET_BENCH_PACKETS, PACKET_BUFFER_SIZE);
+        ESP_LOGI(TAG, "  By copy:    %.2f μs/packet", (float)copy_time / PACKET_BENCH_PACKETS);
+        ESP_LOGI(TAG, "  By pointer: %.2f μs/packet", (float)ptr_time / PACKET_BENCH_PACKETS);
+    }
+    
+    if (pkt) packet_unref(pkt);
+    heap_caps_free(staging);
+    if (copy_queue) vQueueDelete(copy_queue);
+    if (ptr_queue) vQueueDelete(ptr_queue);
+}
+
+void pool_benchmark_task(void *pvParameters) {
+    ESP_LOGI(TAG, "\n🏁 ═══ POOL BENCHMARK ═══");
+    
+    run_contention_benchmark(POOL_MODE_MUTEX);
+    run_contention_benchmark(POOL_MODE_LOCKFREE);
+    run_alloc_latency_benchmark();
+    run_packet_handoff_benchmark();
+    
+    ESP_LOGI(TAG, "═══════════════════════════════════════");
+    vTaskDelete(NULL);
+}
+
+// Histogram smart_pool_malloc() sizes for a window, then recommend pool
+// classes for the RAM the current pools occupy
+void pool_profile_task(void *pvParameters) {
+    size_t budget = 0;
+    for (int i = 0; i < POOL_COUNT; i++) {
+        budget += pool_footprint(pools[i].block_size, pools[i].block_count, pools[i].layout);
+    }
+    
+    ESP_LOGI(TAG, "🔬 Profiling allocation sizes for %d ms", POOL_PROFILE_WINDOW_MS);
+    pool_profile_start();
+    vTaskDelay(pdMS_TO_TICKS(POOL_PROFILE_WINDOW_MS));
+    pool_profile_stop();
+    
+    pool_profile_report(budget);
+    vTaskDelete(NULL);
+}
+
+void analyze_pool_efficiency(void) {
+    ESP_LOGI(TAG, "\n📈 Pool Efficiency Analysis:");
+    
+    for (int i = 0; i < POOL_COUNT; i++) {
+        memory_pool_t* pool = &pools[i];
+        
+        if (pool->total_allocations > 0) {
+            float success_rate = ((float)(pool->total_allocations - pool->allocation_failures) / 
+                                  pool->total_allocations) * 100.0;
+            
+            float utilization = ((float)pool->peak_usage / pool->block_count) * 100.0;
+            
+            float avg_alloc_time = (float)pool->allocation_time_total / pool->total_allocations;
+            float avg_dealloc_time = (float)pool->deallocation_time_total / pool->total_deallocations;
+            
+            ESP_LOGI(TAG, "%s Pool Efficiency:", pool->name);
+            ESP_LOGI(TAG, "  Success Rate: %.1f%%", success_rate);
+            ESP_LOGI(TAG, "  Peak Utilization: %.1f%%", utilization);
+            ESP_LOGI(TAG, "  Avg Alloc Time: %.2f μs", avg_alloc_time);
+            ESP_LOGI(TAG, "  Avg Dealloc Time: %.2f μs", avg_dealloc_time);
+        }
+        
+        if (pool->mutex) {
+            // Footprint against the same pool with inline headers
+            size_t inline_bytes = pool_footprint(pool->block_size, pool->block_count,
+                                                 POOL_LAYOUT_INLINE);
+            size_t actual_bytes = pool_footprint(pool->block_size, pool->block_count,
+                                                 pool->layout);
+            size_t overhead = actual_bytes - pool->block_size * pool->block_count;
+            
+            ESP_LOGI(TAG, "%s Pool Metadata (%s):", pool->name,
+                     pool->layout == POOL_LAYOUT_OOB ? "side table" : "inline headers");
+            ESP_LOGI(TAG, "  Overhead: %d bytes (%.1f%% of payload)", overhead,
+                     (float)overhead * 100.0 / (pool->block_size * pool->block_count));
+            ESP_LOGI(TAG, "  Saved vs Inline: %d bytes", inline_bytes - actual_bytes);
+        }
+    }
+}
+
 void pool_monitor_task(void *pvParameters) {
     ESP_LOGI(TAG, "📊 Pool monitor started");
     
@@ -691,11 +2396,18 @@ void pool_monitor_task(void *pvParameters) {
         print_pool_statistics();
         visualize_pool_usage();
         check_pool_integrity();
+        analyze_pool_efficiency();
         
         // Check for pool exhaustion
         bool any_exhausted = false;
         for (int i = 0; i < POOL_COUNT; i++) {
-            if (pools[i].allocated_blocks >= pools[i].block_count) {
+            size_t cached = 0;
+            for (int core = 0; core < portNUM_PROCESSORS; core++) {
+                cached += pool_caches[core][i].count;
+            }
+            
+            // Blocks parked in a core cache are still available
+            if (pools[i].allocated_blocks - cached >= pools[i].block_count) {
                 any_exhausted = true;
                 break;
             }
@@ -729,6 +2441,13 @@ void app_main(void) {
     gpio_set_level(LED_POOL_FULL, 0);
     gpio_set_level(LED_POOL_ERROR, 0);
     
+    xTaskCreate(activity_indicator_task, "ActivityLED", 2048, NULL,
+                ACTIVITY_TASK_PRIORITY, &activity_ring.task);
+    
+    // A config blob stored by an earlier profiling run overrides the defaults
+    init_pool_config_storage();
+    load_pool_config_from_nvs();
+    
     // Initialize memory pools
     ESP_LOGI(TAG, "Initializing memory pools...");
     
@@ -739,9 +2458,19 @@ void app_main(void) {
         }
     }
     
+    init_pool_caches();
+    build_pool_ranges();
+    build_size_class_table();
     pools_initialized = true;
     ESP_LOGI(TAG, "All memory pools initialized successfully");
     
+    packet_raw_queue = packet_queue_create(PACKET_QUEUE_DEPTH);
+    packet_framed_queue = packet_queue_create(PACKET_QUEUE_DEPTH);
+    if (!packet_pool_init() || !packet_raw_queue || !packet_framed_queue) {
+        ESP_LOGE(TAG, "Failed to initialize packet buffers!");
+        return;
+    }
+    
     // Print initial pool status
     print_pool_statistics();
     
@@ -752,6 +2481,11 @@ void app_main(void) {
     xTaskCreate(pool_stress_test_task, "StressTest", 3072, NULL, 5, NULL);
     xTaskCreate(pool_performance_test_task, "PerfTest", 3072, NULL, 4, NULL);
     xTaskCreate(pool_pattern_test_task, "PatternTest", 3072, NULL, 5, NULL);
+    xTaskCreate(pool_benchmark_task, "PoolBench", 3072, NULL, 3, NULL);
+    xTaskCreate(pool_profile_task, "PoolProfile", 3072, NULL, 2, NULL);
+    xTaskCreate(packet_producer_task, "PktProducer", 2048, NULL, 4, NULL);
+    xTaskCreate(packet_framer_task, "PktFramer", 2048, NULL, 4, NULL);
+    xTaskCreate(packet_consumer_task, "PktConsumer", 3072, NULL, 4, NULL);
     
     ESP_LOGI(TAG, "All tasks created successfully");
     
@@ -763,22 +2497,20 @@ void app_main(void) {
     ESP_LOGI(TAG, "  GPIO19 - Pool Error/Corruption");
     
     ESP_LOGI(TAG, "\n🏊 Pool Configuration:");
-    ESP_LOGI(TAG, "  Small Pool:  %d × %d bytes = %d KB", 
-             SMALL_POOL_BLOCK_COUNT, SMALL_POOL_BLOCK_SIZE,
-             (SMALL_POOL_BLOCK_COUNT * SMALL_POOL_BLOCK_SIZE) / 1024);
-    ESP_LOGI(TAG, "  Medium Pool: %d × %d bytes = %d KB", 
-             MEDIUM_POOL_BLOCK_COUNT, MEDIUM_POOL_BLOCK_SIZE,
-             (MEDIUM_POOL_BLOCK_COUNT * MEDIUM_POOL_BLOCK_SIZE) / 1024);
-    ESP_LOGI(TAG, "  Large Pool:  %d × %d bytes = %d KB", 
-             LARGE_POOL_BLOCK_COUNT, LARGE_POOL_BLOCK_SIZE,
-             (LARGE_POOL_BLOCK_COUNT * LARGE_POOL_BLOCK_SIZE) / 1024);
-    ESP_LOGI(TAG, "  Huge Pool:   %d × %d bytes = %d KB", 
-             HUGE_POOL_BLOCK_COUNT, HUGE_POOL_BLOCK_SIZE,
-             (HUGE_POOL_BLOCK_COUNT * HUGE_POOL_BLOCK_SIZE) / 1024);
+    for (int i = 0; i < POOL_COUNT; i++) {
+        ESP_LOGI(TAG, "  %-7s Pool: %d × %d bytes = %d KB", 
+                 pools[i].name, pools[i].block_count, pools[i].block_size,
+                 (pools[i].block_count * pools[i].block_size) / 1024);
+    }
     
     ESP_LOGI(TAG, "\n🧪 Test Features:");
     ESP_LOGI(TAG, "  • Multi-tier Memory Pool System");
     ESP_LOGI(TAG, "  • Smart Pool Selection");
+    ESP_LOGI(TAG, "  • Lock-free Pool Mode (Small/Medium)");
+    ESP_LOGI(TAG, "  • Per-core Block Caches");
+    ESP_LOGI(TAG, "  • Bitmap Pool Mode with Multi-block Runs (Huge)");
+    ESP_LOGI(TAG, "  • Allocation Size Profiling & NVS Pool Config");
+    ESP_LOGI(TAG, "  • Zero-copy Packet Buffers (refcount, headroom, chaining)");
     ESP_LOGI(TAG, "  • Performance Benchmarking");
     ESP_LOGI(TAG, "  • Corruption Detection");
     ESP_LOGI(TAG, "  • Usage Visualization");
@@ -789,42 +2521,6 @@ void app_main(void) {
 
 
 
-void analyze_pool_efficiency(void) {
-    ESP_LOGI(TAG, "\n📈 Pool Efficiency Analysis:");
-    
-    for (int i = 0; i < POOL_COUNT; i++) {
-        memory_pool_t* pool = &pools[i];
-        
-        if (pool->total_allocations > 0) {
-            float success_rate = ((float)(pool->total_allocations - pool->allocation_failures) / 
-                                  pool->total_allocations) * 100.0;
-            
-            float utilization = ((float)pool->peak_usage / pool->block_count) * 100.0;
-            
-            float avg_alloc_time = (float)pool->allocation_time_total / pool->total_allocations;
-            float avg_dealloc_time = (float)pool->deallocation_time_total / pool->total_deallocations;
-            
-            ESP_LOGI(TAG, "%s Pool Efficiency:", pool->name);
-            ESP_LOGI(TAG, "  Success Rate: %.1f%%", success_rate);
-            ESP_LOGI(TAG, "  Peak Utilization: %.1f%%", utilization);
-            ESP_LOGI(TAG, "  Avg Alloc Time: %.2f μs", avg_alloc_time);
-            ESP_LOGI(TAG, "  Avg Dealloc Time: %.2f μs", avg_dealloc_time);
-        }
-    }
-}
-// Example: Network packet buffer pool
-#define PACKET_BUFFER_SIZE 1500  // Standard Ethernet MTU
-#define PACKET_BUFFER_COUNT 32
-
-typedef struct {
-    uint8_t data[PACKET_BUFFER_SIZE];
-    size_t length;
-    uint64_t timestamp;
-} network_packet_t;
-
-// Use memory pool for network packets to avoid fragmentation
-// and ensure predictable network performance
-
 // Example: Audio sample buffer pool
 #define AUDIO_SAMPLE_SIZE 1024   // 1KB audio samples
 #define AUDIO_BUFFER_COUNT 16
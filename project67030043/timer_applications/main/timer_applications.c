@@ -6,7 +6,9 @@
 #include "freertos/task.h"
 #include "freertos/timers.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "driver/adc.h"
 #include "esp_adc_cal.h"
@@ -31,6 +33,12 @@ static const char *TAG = "TIMER_APPS";
 #define SENSOR_SAMPLE_MS        1000    // Sensor sampling rate
 #define STATUS_UPDATE_MS        3000    // Status update interval
 
+// Deferred work: timer callbacks only enqueue, worker tasks do the slow part
+#define DEFERRED_QUEUE_SIZE     32      // Per lane, power of two
+#define DEFERRED_QUEUE_MASK     (DEFERRED_QUEUE_SIZE - 1)
+#define DEFERRED_WORKER_STACK   3072
+#define CALLBACK_BUDGET_US      1000    // Longer daemon callbacks count as overruns
+
 // Pattern Types
 typedef enum {
     PATTERN_OFF = 0,
@@ -56,9 +64,53 @@ typedef struct {
     uint32_t pattern_changes;
     uint32_t sensor_readings;
     uint32_t system_uptime_sec;
+    uint32_t callback_overruns;
     bool system_healthy;
 } system_health_t;
 
+// Deferred Work Item: same shape as a FreeRTOS pended function call
+typedef void (*deferred_fn_t)(void* param, uint32_t arg);
+
+typedef struct {
+    deferred_fn_t fn;
+    void* param;
+    uint32_t arg;
+    int64_t enqueued_us;
+} deferred_work_t;
+
+// Bounded MPMC ring: a cell's sequence says whose turn it is
+typedef struct {
+    uint32_t sequence;
+    deferred_work_t work;
+} deferred_cell_t;
+
+typedef enum {
+    DEFER_URGENT = 0,      // Watchdog alarm, sensor sampling
+    DEFER_BACKGROUND,      // Logging and status reports
+    DEFER_LANE_COUNT
+} deferred_lane_id_t;
+
+typedef struct {
+    const char* name;
+    UBaseType_t priority;
+    uint8_t workers;
+    deferred_cell_t cells[DEFERRED_QUEUE_SIZE];
+    uint32_t enqueue_pos;
+    uint32_t dequeue_pos;
+    SemaphoreHandle_t ready;     // Counts published items, wakes a worker
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t dropped;            // Lane full: the callback carried on without it
+    uint32_t max_latency_us;     // Enqueue to start of execution
+} deferred_lane_t;
+
+// Timer daemon occupancy, written only by the daemon task itself
+typedef struct {
+    uint64_t busy_us;
+    uint32_t callbacks;
+    uint32_t max_callback_us;
+} daemon_stats_t;
+
 // Global Variables
 TimerHandle_t watchdog_timer;
 TimerHandle_t feed_timer;
@@ -71,7 +123,14 @@ QueueHandle_t pattern_queue;
 
 led_pattern_t current_pattern = PATTERN_OFF;
 int pattern_step = 0;
-system_health_t health_stats = {0, 0, 0, 0, 0, true};
+system_health_t health_stats = {0, 0, 0, 0, 0, 0, true};
+
+// Worker lanes: priority and worker count are the knobs
+deferred_lane_t deferred_lanes[DEFER_LANE_COUNT] = {
+    [DEFER_URGENT]     = {.name = "urgent",     .priority = 5, .workers = 2},
+    [DEFER_BACKGROUND] = {.name = "background", .priority = 2, .workers = 1},
+};
+daemon_stats_t daemon_stats = {0};
 
 // Pattern state for complex patterns
 typedef struct {
@@ -86,15 +145,148 @@ pattern_state_t pattern_state = {0, 1, 0, false};
 // ADC calibration
 esp_adc_cal_characteristics_t *adc_chars;
 
-// ================ WATCHDOG SYSTEM ================
+// Forward declarations
+void recovery_callback(TimerHandle_t timer);
+void change_led_pattern(led_pattern_t new_pattern);
 
-void watchdog_timeout_callback(TimerHandle_t timer) {
-    health_stats.watchdog_timeouts++;
-    health_stats.system_healthy = false;
+// ================ DEFERRED WORK ================
+
+// Lock-free enqueue; never blocks, so it is safe from timer callbacks
+bool deferred_submit(deferred_lane_id_t id, deferred_fn_t fn, void* param, uint32_t arg) {
+    deferred_lane_t* lane = &deferred_lanes[id];
+    uint32_t pos = __atomic_load_n(&lane->enqueue_pos, __ATOMIC_RELAXED);
+    deferred_cell_t* cell;
+    
+    while (1) {
+        cell = &lane->cells[pos & DEFERRED_QUEUE_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&lane->enqueue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            __atomic_fetch_add(&lane->dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        } else {
+            pos = __atomic_load_n(&lane->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    cell->work.fn = fn;
+    cell->work.param = param;
+    cell->work.arg = arg;
+    cell->work.enqueued_us = esp_timer_get_time();
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    
+    __atomic_fetch_add(&lane->submitted, 1, __ATOMIC_RELAXED);
+    xSemaphoreGive(lane->ready);
+    return true;
+}
+
+static bool deferred_take(deferred_lane_t* lane, deferred_work_t* work) {
+    uint32_t pos = __atomic_load_n(&lane->dequeue_pos, __ATOMIC_RELAXED);
+    deferred_cell_t* cell;
     
+    while (1) {
+        cell = &lane->cells[pos & DEFERRED_QUEUE_MASK];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&lane->dequeue_pos, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&lane->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+    
+    *work = cell->work;
+    __atomic_store_n(&cell->sequence, pos + DEFERRED_QUEUE_SIZE, __ATOMIC_RELEASE);
+    return true;
+}
+
+void deferred_worker_task(void *parameter) {
+    deferred_lane_t* lane = (deferred_lane_t*)parameter;
+    deferred_work_t work;
+    
+    while (1) {
+        xSemaphoreTake(lane->ready, portMAX_DELAY);
+        
+        // An earlier slot may still be mid-publish by a preempted producer
+        while (!deferred_take(lane, &work)) {
+            vTaskDelay(1);
+        }
+        
+        // Lanes can have several workers, so the max is updated with a CAS
+        uint32_t latency_us = esp_timer_get_time() - work.enqueued_us;
+        uint32_t seen = __atomic_load_n(&lane->max_latency_us, __ATOMIC_RELAXED);
+        while (latency_us > seen &&
+               !__atomic_compare_exchange_n(&lane->max_latency_us, &seen, latency_us, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+        
+        work.fn(work.param, work.arg);
+        __atomic_fetch_add(&lane->completed, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void init_deferred_work(void) {
+    for (int i = 0; i < DEFER_LANE_COUNT; i++) {
+        deferred_lane_t* lane = &deferred_lanes[i];
+        
+        for (int c = 0; c < DEFERRED_QUEUE_SIZE; c++) {
+            lane->cells[c].sequence = c;
+        }
+        lane->ready = xSemaphoreCreateCounting(DEFERRED_QUEUE_SIZE, 0);
+        
+        for (int w = 0; w < lane->workers; w++) {
+            char name[16];
+            snprintf(name, sizeof(name), "Defer%s%d", i == DEFER_URGENT ? "Urg" : "Bg", w);
+            xTaskCreate(deferred_worker_task, name, DEFERRED_WORKER_STACK, lane,
+                        lane->priority, NULL);
+        }
+    }
+    
+    ESP_LOGI(TAG, "Deferred work lanes started (queue %d per lane)", DEFERRED_QUEUE_SIZE);
+}
+
+// Static strings only: the pointer is logged later, on a worker
+void deferred_log_work(void* message, uint32_t arg) {
+    ESP_LOGI(TAG, "%s", (const char*)message);
+}
+
+static inline void deferred_log(const char* message) {
+    deferred_submit(DEFER_BACKGROUND, deferred_log_work, (void*)message, 0);
+}
+
+// Bracket every timer callback to measure how busy the daemon task is
+static inline int64_t daemon_callback_begin(void) {
+    return esp_timer_get_time();
+}
+
+static void daemon_callback_end(int64_t start_us) {
+    uint32_t duration_us = esp_timer_get_time() - start_us;
+    
+    daemon_stats.busy_us += duration_us;
+    daemon_stats.callbacks++;
+    if (duration_us > daemon_stats.max_callback_us) {
+        daemon_stats.max_callback_us = duration_us;
+    }
+    if (duration_us > CALLBACK_BUDGET_US) {
+        health_stats.callback_overruns++;
+    }
+}
+
+// ================ WATCHDOG SYSTEM ================
+
+// Runs on an urgent worker: the LED flash takes a second of vTaskDelay
+void watchdog_alarm_work(void* param, uint32_t timeouts) {
     ESP_LOGE(TAG, "🚨 WATCHDOG TIMEOUT! System may be hung!");
     ESP_LOGE(TAG, "System stats: Feeds=%lu, Timeouts=%lu", 
-             health_stats.watchdog_feeds, health_stats.watchdog_timeouts);
+             health_stats.watchdog_feeds, timeouts);
     
     // Flash watchdog LED rapidly
     for (int i = 0; i < 10; i++) {
@@ -112,13 +304,37 @@ void watchdog_timeout_callback(TimerHandle_t timer) {
     health_stats.system_healthy = true;
 }
 
+void watchdog_timeout_callback(TimerHandle_t timer) {
+    int64_t start = daemon_callback_begin();
+    
+    health_stats.watchdog_timeouts++;
+    health_stats.system_healthy = false;
+    
+    if (!deferred_submit(DEFER_URGENT, watchdog_alarm_work, NULL, health_stats.watchdog_timeouts)) {
+        // No worker slot: re-arm directly so the watchdog keeps running
+        xTimerReset(watchdog_timer, 0);
+    }
+    
+    daemon_callback_end(start);
+}
+
+void feed_log_work(void* param, uint32_t feed_number) {
+    ESP_LOGI(TAG, "🍖 Feeding watchdog (feed #%lu)", feed_number);
+    
+    // Flash status LED briefly
+    gpio_set_level(STATUS_LED, 1);
+    vTaskDelay(pdMS_TO_TICKS(50));
+    gpio_set_level(STATUS_LED, 0);
+}
+
 void feed_watchdog_callback(TimerHandle_t timer) {
     static int feed_count = 0;
+    int64_t start = daemon_callback_begin();
     feed_count++;
     
     // Simulate occasional system issues
     if (feed_count == 15) {
-        ESP_LOGW(TAG, "🐛 Simulating system hang - stopping watchdog feeds for 8 seconds");
+        deferred_log("🐛 Simulating system hang - stopping watchdog feeds for 8 seconds");
         xTimerStop(feed_timer, 0);
         
         // Create recovery timer
@@ -128,25 +344,27 @@ void feed_watchdog_callback(TimerHandle_t timer) {
                                                    (void*)0,
                                                    recovery_callback);
         xTimerStart(recovery_timer, 0);
+        daemon_callback_end(start);
         return;
     }
     
     health_stats.watchdog_feeds++;
-    ESP_LOGI(TAG, "🍖 Feeding watchdog (feed #%lu)", health_stats.watchdog_feeds);
     
-    // Reset watchdog timer
+    // Reset watchdog timer here; only the report is deferred
     xTimerReset(watchdog_timer, 0);
+    deferred_submit(DEFER_BACKGROUND, feed_log_work, NULL, health_stats.watchdog_feeds);
     
-    // Flash status LED briefly
-    gpio_set_level(STATUS_LED, 1);
-    vTaskDelay(pdMS_TO_TICKS(50));
-    gpio_set_level(STATUS_LED, 0);
+    daemon_callback_end(start);
 }
 
 void recovery_callback(TimerHandle_t timer) {
-    ESP_LOGI(TAG, "🔄 System recovered - resuming watchdog feeds");
+    int64_t start = daemon_callback_begin();
+    
+    deferred_log("🔄 System recovered - resuming watchdog feeds");
     xTimerStart(feed_timer, 0);
     xTimerDelete(timer, 0);
+    
+    daemon_callback_end(start);
 }
 
 // ================ LED PATTERN SYSTEM ================
@@ -159,6 +377,7 @@ void set_pattern_leds(bool led1, bool led2, bool led3) {
 
 void pattern_timer_callback(TimerHandle_t timer) {
     static uint32_t pattern_cycle = 0;
+    int64_t start = daemon_callback_begin();
     pattern_cycle++;
     
     switch (current_pattern) {
@@ -171,7 +390,7 @@ void pattern_timer_callback(TimerHandle_t timer) {
             pattern_state.state = !pattern_state.state;
             set_pattern_leds(pattern_state.state, 0, 0);
             xTimerChangePeriod(timer, pdMS_TO_TICKS(1000), 0);
-            ESP_LOGI(TAG, "💡 Slow Blink: %s", pattern_state.state ? "ON" : "OFF");
+            deferred_log(pattern_state.state ? "💡 Slow Blink: ON" : "💡 Slow Blink: OFF");
             break;
             
         case PATTERN_FAST_BLINK:
@@ -187,7 +406,7 @@ void pattern_timer_callback(TimerHandle_t timer) {
             set_pattern_leds(0, 0, pulse);
             pattern_step++;
             xTimerChangePeriod(timer, pdMS_TO_TICKS(100), 0);
-            if (step == 9) ESP_LOGI(TAG, "💓 Heartbeat pulse");
+            if (step == 9) deferred_log("💓 Heartbeat pulse");
             break;
         }
         
@@ -203,8 +422,8 @@ void pattern_timer_callback(TimerHandle_t timer) {
             
             sos_pos = (sos_pos + 1) % strlen(sos);
             if (sos_pos == 0) {
-                ESP_LOGI(TAG, "🆘 SOS Pattern Complete");
-                vTaskDelay(pdMS_TO_TICKS(1000)); // Pause between repeats
+                deferred_log("🆘 SOS Pattern Complete");
+                duration += 1000; // Pause between repeats, without blocking the daemon
             }
             
             xTimerChangePeriod(timer, pdMS_TO_TICKS(duration), 0);
@@ -221,7 +440,7 @@ void pattern_timer_callback(TimerHandle_t timer) {
             set_pattern_leds(led1, led2, led3);
             pattern_step++;
             
-            if (rainbow_step == 7) ESP_LOGI(TAG, "🌈 Rainbow cycle complete");
+            if (rainbow_step == 7) deferred_log("🌈 Rainbow cycle complete");
             xTimerChangePeriod(timer, pdMS_TO_TICKS(300), 0);
             break;
         }
@@ -236,16 +455,24 @@ void pattern_timer_callback(TimerHandle_t timer) {
         led_pattern_t new_pattern = (current_pattern + 1) % PATTERN_MAX;
         change_led_pattern(new_pattern);
     }
+    
+    daemon_callback_end(start);
 }
 
-void change_led_pattern(led_pattern_t new_pattern) {
+void pattern_change_log_work(void* param, uint32_t patterns) {
     const char* pattern_names[] = {
         "OFF", "SLOW_BLINK", "FAST_BLINK", 
         "HEARTBEAT", "SOS", "RAINBOW"
     };
     
     ESP_LOGI(TAG, "🎨 Changing pattern: %s -> %s", 
-             pattern_names[current_pattern], pattern_names[new_pattern]);
+             pattern_names[patterns >> 8], pattern_names[patterns & 0xFF]);
+}
+
+// Called from the pattern timer callback as well as from tasks
+void change_led_pattern(led_pattern_t new_pattern) {
+    deferred_submit(DEFER_BACKGROUND, pattern_change_log_work, NULL,
+                    ((uint32_t)current_pattern << 8) | new_pattern);
     
     current_pattern = new_pattern;
     pattern_step = 0;
@@ -280,7 +507,8 @@ float read_sensor_value(void) {
     return sensor_value;
 }
 
-void sensor_timer_callback(TimerHandle_t timer) {
+// Runs on an urgent worker: sensor power-up waits 10 ms before the ADC read
+void sensor_sample_work(void* param, uint32_t unused) {
     sensor_data_t sensor_data;
     
     sensor_data.value = read_sensor_value();
@@ -290,8 +518,7 @@ void sensor_timer_callback(TimerHandle_t timer) {
     health_stats.sensor_readings++;
     
     // Send to processing queue
-    BaseType_t higher_priority_task_woken = pdFALSE;
-    if (xQueueSendFromISR(sensor_queue, &sensor_data, &higher_priority_task_woken) != pdTRUE) {
+    if (xQueueSend(sensor_queue, &sensor_data, 0) != pdTRUE) {
         ESP_LOGW(TAG, "Sensor queue full - dropping sample");
     }
     
@@ -305,13 +532,22 @@ void sensor_timer_callback(TimerHandle_t timer) {
         new_period = pdMS_TO_TICKS(2000); // Low temp - sample slower
     }
     
-    xTimerChangePeriodFromISR(timer, new_period, &higher_priority_task_woken);
-    portYIELD_FROM_ISR(higher_priority_task_woken);
+    xTimerChangePeriod(sensor_timer, new_period, 0);
+}
+
+void sensor_timer_callback(TimerHandle_t timer) {
+    int64_t start = daemon_callback_begin();
+    deferred_submit(DEFER_URGENT, sensor_sample_work, NULL, 0);
+    daemon_callback_end(start);
 }
 
 // ================ STATUS SYSTEM ================
 
-void status_timer_callback(TimerHandle_t timer) {
+// Runs on the background worker, well away from the daemon
+void status_report_work(void* param, uint32_t unused) {
+    static uint64_t last_busy_us = 0;
+    static int64_t last_report_us = 0;
+    
     health_stats.system_uptime_sec = pdTICKS_TO_MS(xTaskGetTickCount()) / 1000;
     
     ESP_LOGI(TAG, "\n═══════ SYSTEM STATUS ═══════");
@@ -329,6 +565,25 @@ void status_timer_callback(TimerHandle_t timer) {
     ESP_LOGI(TAG, "  Feed: %s", xTimerIsTimerActive(feed_timer) ? "ACTIVE" : "INACTIVE");
     ESP_LOGI(TAG, "  Pattern: %s", xTimerIsTimerActive(pattern_timer) ? "ACTIVE" : "INACTIVE");
     ESP_LOGI(TAG, "  Sensor: %s", xTimerIsTimerActive(sensor_timer) ? "ACTIVE" : "INACTIVE");
+    
+    // Daemon occupancy since the previous report
+    int64_t now_us = esp_timer_get_time();
+    uint64_t busy_us = daemon_stats.busy_us;
+    if (last_report_us > 0) {
+        float occupancy = (float)(busy_us - last_busy_us) * 100.0 / (now_us - last_report_us);
+        ESP_LOGI(TAG, "Timer Daemon: %.2f%% busy, %lu callbacks, max %lu μs, %lu overruns",
+                 occupancy, daemon_stats.callbacks, daemon_stats.max_callback_us,
+                 health_stats.callback_overruns);
+    }
+    last_busy_us = busy_us;
+    last_report_us = now_us;
+    
+    ESP_LOGI(TAG, "Deferred Work (submitted/completed/dropped, max latency):");
+    for (int i = 0; i < DEFER_LANE_COUNT; i++) {
+        deferred_lane_t* lane = &deferred_lanes[i];
+        ESP_LOGI(TAG, "  %-10s %lu/%lu/%lu, %lu μs", lane->name, lane->submitted,
+                 lane->completed, lane->dropped, lane->max_latency_us);
+    }
     ESP_LOGI(TAG, "════════════════════════════\n");
     
     // Flash status LED
@@ -337,6 +592,12 @@ void status_timer_callback(TimerHandle_t timer) {
     gpio_set_level(STATUS_LED, 0);
 }
 
+void status_timer_callback(TimerHandle_t timer) {
+    int64_t start = daemon_callback_begin();
+    deferred_submit(DEFER_BACKGROUND, status_report_work, NULL, 0);
+    daemon_callback_end(start);
+}
+
 // ================ PROCESSING TASKS ================
 
 void sensor_processing_task(void *parameter) {
@@ -520,6 +781,7 @@ void app_main(void) {
     // Initialize components
     init_hardware();
     create_queues();
+    init_deferred_work();
     create_timers();
     
     // Start the system